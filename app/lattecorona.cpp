@@ -82,6 +82,8 @@
 #include <KWayland/Client/plasmashell.h>
 #include <KWayland/Client/plasmawindowmanagement.h>
 
+#define MAXIMUMID 32000
+
 namespace Latte {
 
 Corona::Corona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp, int userSetMemoryUsage, QObject *parent)
@@ -128,6 +130,8 @@ Corona::Corona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp, int use
 
     qmlRegisterTypes();
 
+    connect(this, &Plasma::Corona::containmentAdded, this, &Corona::trackIds);
+
     if (m_activityConsumer && (m_activityConsumer->serviceStatus() == KActivities::Consumer::Running)) {
         load();
     }
@@ -135,12 +139,19 @@ Corona::Corona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp, int use
     connect(m_activityConsumer, &KActivities::Consumer::serviceStatusChanged, this, &Corona::load);
 
     m_viewsScreenSyncTimer.setSingleShot(true);
-    m_viewsScreenSyncTimer.setInterval(m_universalSettings->screenTrackerInterval());
+    m_viewsScreenSyncTimer.setInterval(m_universalSettings->screenTrackerDelay());
     connect(&m_viewsScreenSyncTimer, &QTimer::timeout, this, &Corona::syncLatteViewsToScreens);
     connect(m_universalSettings, &UniversalSettings::screenTrackerIntervalChanged, this, [this]() {
-        m_viewsScreenSyncTimer.setInterval(m_universalSettings->screenTrackerInterval());
+        m_viewsScreenSyncTimer.setInterval(m_universalSettings->screenTrackerDelay());
+    });
+    connect(m_universalSettings, &UniversalSettings::screenTrackerPollingChanged, this, [this]() {
+        m_viewsScreenSyncTimer.setInterval(m_universalSettings->screenTrackerDelay());
     });
 
+    //! must be connected before any view in order to invalidate the cached
+    //! available screen geometries before views are informed
+    connect(this, &Corona::availableScreenRectChangedFrom, this, &Corona::availableScreenChangedFrom);
+
     //! initialize the background tracer for broadcasted backgrounds
     m_backgroundTracer = new KDeclarative::QmlObjectSharedEngine(this);
     m_backgroundTracer->setInitializationDelayed(true);
@@ -183,6 +194,16 @@ Corona::~Corona()
 
     m_layoutsManager->unload();
 
+    //! remaining containments and applets are deleted afterwards from Plasma::Corona,
+    //! their ids must not be untracked at that point
+    for (const auto containment : containments()) {
+        disconnect(containment, nullptr, this, nullptr);
+
+        for (const auto applet : containment->applets()) {
+            disconnect(applet, nullptr, this, nullptr);
+        }
+    }
+
     m_wm->deleteLater();
     m_globalShortcuts->deleteLater();
     m_layoutsManager->deleteLater();
@@ -212,6 +233,7 @@ void Corona::load()
         connect(this, &Corona::availableScreenRegionChangedFrom, this, &Plasma::Corona::availableScreenRegionChanged);
 
         connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, &Corona::primaryOutputChanged, Qt::UniqueConnection);
+        connect(qGuiApp, &QGuiApplication::screenRemoved, this, &Corona::screenRemoved, Qt::UniqueConnection);
         connect(QApplication::desktop(), &QDesktopWidget::screenCountChanged, this, &Corona::screenCountChanged);
 
         connect(m_screenPool, &ScreenPool::primaryPoolChanged, this, &Corona::screenCountChanged);
@@ -450,23 +472,12 @@ int Corona::numScreens() const
 
 QRect Corona::screenGeometry(int id) const
 {
-    const auto screens = qGuiApp->screens();
-    const QScreen *screen{qGuiApp->primaryScreen()};
-
-    QString screenName;
-
-    if (m_screenPool->hasId(id)) {
-        screenName = m_screenPool->connector(id);
-    }
-
-    for(const auto scr : screens) {
-        if (scr->name() == screenName) {
-            screen = scr;
-            break;
-        }
-    }
+    return screenForId(id)->geometry();
+}
 
-    return screen->geometry();
+QScreen *Corona::screenForId(int id) const
+{
+    return m_screenPool->screenForId(id);
 }
 
 QRegion Corona::availableScreenRegion(int id) const
@@ -476,32 +487,12 @@ QRegion Corona::availableScreenRegion(int id) const
 
 QRegion Corona::availableScreenRegionWithCriteria(int id, QString forLayout) const
 {
-    const auto screens = qGuiApp->screens();
-    const QScreen *screen{qGuiApp->primaryScreen()};
-
-    QString screenName;
-
-    if (m_screenPool->hasId(id)) {
-        screenName = m_screenPool->connector(id);
-    }
-
-    for(auto scr : screens) {
-        if (scr->name() == screenName) {
-            screen = scr;
-            break;
-        }
-    }
-
-    if (!screen)
-        return QRegion();
-
-    QList<Latte::View *> views;
+    Layout::GenericLayout *generic{nullptr};
 
     if (forLayout.isEmpty()) {
-        Latte::CentralLayout *currentLayout = m_layoutsManager->currentLayout();
-        views = currentLayout->latteViews();
+        generic = m_layoutsManager->currentLayout();
     } else {
-        Layout::GenericLayout *generic = m_layoutsManager->synchronizer()->centralLayout(forLayout);
+        generic = m_layoutsManager->synchronizer()->centralLayout(forLayout);
 
         if (!generic) {
             //! Identify best active layout to be used for metrics calculations.
@@ -516,7 +507,22 @@ QRegion Corona::availableScreenRegionWithCriteria(int id, QString forLayout) con
         if (!generic) {
             generic = m_layoutsManager->currentLayout();
         }
+    }
 
+    const QString layoutName = generic ? generic->name() : QString();
+
+    if (m_availableScreenCache.contains(id) && m_availableScreenCache[id].regions.contains(layoutName)) {
+        return m_availableScreenCache[id].regions[layoutName];
+    }
+
+    QScreen *screen = screenForId(id);
+
+    if (!screen)
+        return QRegion();
+
+    QList<Latte::View *> views;
+
+    if (generic) {
         views = generic->latteViews();
     }
 
@@ -537,22 +543,23 @@ QRegion Corona::availableScreenRegionWithCriteria(int id, QString forLayout) con
                     available -= view->geometry();
                 } else {
                     QRect realGeometry;
-                    int realWidth = view->maxLength() * view->width();
+                    const QRect fullGeometry = view->fullGeometry();
+                    int realWidth = view->maxLength() * fullGeometry.width();
 
                     switch (view->alignment()) {
                     case Latte::Types::Left:
-                        realGeometry = QRect(view->x(), view->y(),
+                        realGeometry = QRect(fullGeometry.x(), fullGeometry.y(),
                                              realWidth, realThickness);
                         break;
 
                     case Latte::Types::Center:
                     case Latte::Types::Justify:
-                        realGeometry = QRect(qMax(view->geometry().x(), view->geometry().center().x() - realWidth / 2), view->y(),
+                        realGeometry = QRect(qMax(fullGeometry.x(), fullGeometry.center().x() - realWidth / 2), fullGeometry.y(),
                                              realWidth, realThickness);
                         break;
 
                     case Latte::Types::Right:
-                        realGeometry = QRect(view->geometry().right() - realWidth + 1, view->y(),
+                        realGeometry = QRect(fullGeometry.right() - realWidth + 1, fullGeometry.y(),
                                              realWidth, realThickness);
                         break;
                     }
@@ -567,23 +574,24 @@ QRegion Corona::availableScreenRegionWithCriteria(int id, QString forLayout) con
                     available -= view->geometry();
                 } else {
                     QRect realGeometry;
-                    int realWidth = view->maxLength() * view->width();
-                    int realY = view->geometry().bottom() - realThickness + 1;
+                    const QRect fullGeometry = view->fullGeometry();
+                    int realWidth = view->maxLength() * fullGeometry.width();
+                    int realY = fullGeometry.bottom() - realThickness + 1;
 
                     switch (view->alignment()) {
                     case Latte::Types::Left:
-                        realGeometry = QRect(view->x(), realY,
+                        realGeometry = QRect(fullGeometry.x(), realY,
                                              realWidth, realThickness);
                         break;
 
                     case Latte::Types::Center:
                     case Latte::Types::Justify:
-                        realGeometry = QRect(qMax(view->geometry().x(), view->geometry().center().x() - realWidth / 2),
+                        realGeometry = QRect(qMax(fullGeometry.x(), fullGeometry.center().x() - realWidth / 2),
                                              realY, realWidth, realThickness);
                         break;
 
                     case Latte::Types::Right:
-                        realGeometry = QRect(view->geometry().right() - realWidth + 1, realY,
+                        realGeometry = QRect(fullGeometry.right() - realWidth + 1, realY,
                                              realWidth, realThickness);
                         break;
                     }
@@ -608,6 +616,9 @@ QRegion Corona::availableScreenRegionWithCriteria(int id, QString forLayout) con
 
     qDebug() << "::::: END OF FREE AREAS :::::";*/
 
+    m_availableScreenCache[id].screen = screen;
+    m_availableScreenCache[id].regions[layoutName] = available;
+
     return available;
 }
 
@@ -618,20 +629,28 @@ QRect Corona::availableScreenRect(int id) const
 
 QRect Corona::availableScreenRectWithCriteria(int id, QList<Types::Visibility> modes, QList<Plasma::Types::Location> edges) const
 {
-    const auto screens = qGuiApp->screens();
-    const QScreen *screen{qGuiApp->primaryScreen()};
+    Latte::CentralLayout *currentLayout = m_layoutsManager->currentLayout();
 
-    if (m_screenPool->hasId(id)) {
-        QString scrName = m_screenPool->connector(id);
+    //! cache key: layout name and the requested modes/edges
+    QString criteria = currentLayout ? currentLayout->name() : QString();
+    criteria += QLatin1Char('|');
 
-        for(const auto scr : screens) {
-            if (scr->name() == scrName) {
-                screen = scr;
-                break;
-            }
-        }
+    for (const auto mode : modes) {
+        criteria += QString::number(static_cast<int>(mode)) + QLatin1Char(',');
+    }
+
+    criteria += QLatin1Char('|');
+
+    for (const auto edge : edges) {
+        criteria += QString::number(static_cast<int>(edge)) + QLatin1Char(',');
     }
 
+    if (m_availableScreenCache.contains(id) && m_availableScreenCache[id].rects.contains(criteria)) {
+        return m_availableScreenCache[id].rects[criteria];
+    }
+
+    QScreen *screen = screenForId(id);
+
     if (!screen)
         return {};
 
@@ -641,7 +660,6 @@ QRect Corona::availableScreenRectWithCriteria(int id, QList<Types::Visibility> m
 
     auto available = screen->geometry();
 
-    Latte::CentralLayout *currentLayout = m_layoutsManager->currentLayout();
     QList<Latte::View *> views;
 
     if (currentLayout) {
@@ -681,9 +699,117 @@ QRect Corona::availableScreenRectWithCriteria(int id, QList<Types::Visibility> m
         }
     }
 
+    m_availableScreenCache[id].screen = screen;
+    m_availableScreenCache[id].rects[criteria] = available;
+
     return available;
 }
 
+void Corona::invalidateAvailableScreenCacheOn(QScreen *screen)
+{
+    auto i = m_availableScreenCache.begin();
+
+    while (i != m_availableScreenCache.end()) {
+        if (i.value().screen == screen) {
+            i = m_availableScreenCache.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+QList<QScreen *> Corona::viewAffectedScreens(Latte::View *view)
+{
+    QList<QScreen *> screens;
+
+    if (!view) {
+        return screens;
+    }
+
+    if (!m_viewScreens.contains(view)) {
+        connect(view, &QObject::destroyed, this, [this, view]() {
+            m_viewScreens.remove(view);
+        });
+    }
+
+    //! the previous screen is also affected when the view changes screens
+    QScreen *previous = m_viewScreens[view];
+
+    if (previous && previous != view->screen()) {
+        screens << previous;
+    }
+
+    if (view->screen()) {
+        screens << view->screen();
+    }
+
+    m_viewScreens[view] = view->screen();
+
+    return screens;
+}
+
+void Corona::invalidateAvailableScreenCache(Latte::View *view)
+{
+    for (const auto scr : viewAffectedScreens(view)) {
+        invalidateAvailableScreenCacheOn(scr);
+    }
+}
+
+void Corona::updateAvailableScreenCache(Latte::View *view)
+{
+    bool rectChanged{false};
+    bool regionChanged{false};
+
+    for (const auto scr : viewAffectedScreens(view)) {
+        const int id = m_screenPool->id(scr);
+
+        if (id < 0) {
+            invalidateAvailableScreenCacheOn(scr);
+            continue;
+        }
+
+        const QRect previousRect = availableScreenRect(id);
+        const QRegion previousRegion = availableScreenRegion(id);
+
+        invalidateAvailableScreenCacheOn(scr);
+
+        const bool screenRectChanged = (availableScreenRect(id) != previousRect);
+        const bool screenRegionChanged = (availableScreenRegion(id) != previousRegion);
+
+        if (screenRectChanged || screenRegionChanged) {
+            emit availableScreenRectChangedOn(scr, view);
+        }
+
+        rectChanged = rectChanged || screenRectChanged;
+        regionChanged = regionChanged || screenRegionChanged;
+    }
+
+    if (rectChanged) {
+        emit availableScreenRectChanged();
+    }
+
+    if (regionChanged) {
+        emit availableScreenRegionChanged();
+    }
+}
+
+void Corona::availableScreenChangedFrom(Latte::View *origin)
+{
+    for (const auto scr : viewAffectedScreens(origin)) {
+        invalidateAvailableScreenCacheOn(scr);
+        emit availableScreenRectChangedOn(scr, origin);
+    }
+}
+
+void Corona::resetAvailableScreenCache()
+{
+    m_availableScreenCache.clear();
+
+    for (const auto scr : qGuiApp->screens()) {
+        emit availableScreenRectChangedOn(scr, nullptr);
+    }
+}
+
 void Corona::addOutput(QScreen *screen)
 {
     Q_ASSERT(screen);
@@ -696,31 +822,47 @@ void Corona::addOutput(QScreen *screen)
     }
 
     connect(screen, &QScreen::geometryChanged, this, [ = ]() {
-        const int id = m_screenPool->id(screen->name());
+        const int id = m_screenPool->id(screen);
 
         if (id >= 0) {
+            invalidateAvailableScreenCacheOn(screen);
+            emit availableScreenRectChangedOn(screen, nullptr);
             emit screenGeometryChanged(id);
             emit availableScreenRegionChanged();
             emit availableScreenRectChanged();
         }
     });
 
+    resetAvailableScreenCache();
     emit availableScreenRectChanged();
-    emit screenAdded(m_screenPool->id(screen->name()));
+    emit screenAdded(m_screenPool->id(screen));
 }
 
 void Corona::primaryOutputChanged()
 {
-    m_viewsScreenSyncTimer.start();
+    resetAvailableScreenCache();
+    scheduleViewsScreenSync();
 }
 
 void Corona::screenRemoved(QScreen *screen)
 {
     Q_ASSERT(screen);
+
+    m_availableScreenCache.clear();
 }
 
 void Corona::screenCountChanged()
 {
+    resetAvailableScreenCache();
+    scheduleViewsScreenSync();
+}
+
+void Corona::scheduleViewsScreenSync()
+{
+    if (!m_viewsScreenSyncTimer.isActive()) {
+        m_screensChangedTime.start();
+    }
+
     m_viewsScreenSyncTimer.start();
 }
 
@@ -729,6 +871,66 @@ void Corona::screenCountChanged()
 void Corona::syncLatteViewsToScreens()
 {
     m_layoutsManager->synchronizer()->syncLatteViewsToScreens();
+
+    if (m_screensChangedTime.isValid()) {
+        trackScreensChangedViews();
+    }
+}
+
+void Corona::trackScreensChangedViews()
+{
+    for (const auto &connection : m_screensChangedConnections) {
+        disconnect(connection);
+    }
+
+    m_screensChangedConnections.clear();
+    m_screensChangedViews.clear();
+
+    //! views that were added or moved to another screen have either not been exposed yet
+    //! or their new geometry is still waiting in their window transaction
+    for (const auto view : m_layoutsManager->synchronizer()->currentViews()) {
+        if (view->isExposed() && !view->windowTransaction()->isPending()) {
+            continue;
+        }
+
+        m_screensChangedViews << view;
+
+        m_screensChangedConnections << connect(view->positioner(), &ViewPart::Positioner::windowGeometryCommitted, this, [this, view]() {
+            screensChangedViewShown(view);
+        });
+
+        m_screensChangedConnections << connect(view, &Latte::View::eventTriggered, this, [this, view](QEvent *e) {
+            if (e->type() == QEvent::Expose && view->isExposed()) {
+                screensChangedViewShown(view);
+            }
+        });
+
+        //! deleted views are not waited for
+        m_screensChangedConnections << connect(view, &QObject::destroyed, this, [this, view]() {
+            screensChangedViewShown(view);
+        });
+    }
+
+    if (m_screensChangedViews.isEmpty()) {
+        qDebug() << "screens changed, no views needed to be shown again, synced after ms ::: " << m_screensChangedTime.elapsed();
+        m_screensChangedTime.invalidate();
+    }
+}
+
+void Corona::screensChangedViewShown(const Latte::View *view)
+{
+    if (!m_screensChangedViews.removeOne(view) || !m_screensChangedViews.isEmpty()) {
+        return;
+    }
+
+    for (const auto &connection : m_screensChangedConnections) {
+        disconnect(connection);
+    }
+
+    m_screensChangedConnections.clear();
+
+    qDebug() << "screens changed, hotplug to views visible latency ms ::: " << m_screensChangedTime.elapsed();
+    m_screensChangedTime.invalidate();
 }
 
 int Corona::primaryScreenId() const
@@ -793,7 +995,7 @@ int Corona::screenForContainment(const Plasma::Containment *containment) const
     Latte::View *view =  m_layoutsManager->synchronizer()->viewForContainment(c);
 
     if (view && view->screen()) {
-        return m_screenPool->id(view->screen()->name());
+        return m_screenPool->id(view->screen());
     }
 
     //Failed? fallback on lastScreen()
@@ -803,13 +1005,11 @@ int Corona::screenForContainment(const Plasma::Containment *containment) const
     //won't be associated to a screen
     //     qDebug() << "ShellCorona screenForContainment: " << containment << " Last screen is " << containment->lastScreen();
 
-    for (auto screen : qGuiApp->screens()) {
-        // containment->lastScreen() == m_screenPool->id(screen->name()) to check if the lastScreen refers to a screen that exists/it's known
-        if (containment->lastScreen() == m_screenPool->id(screen->name()) &&
-                (containment->activity() == m_activityConsumer->currentActivity() ||
-                 containment->containmentType() == Plasma::Types::PanelContainment || containment->containmentType() == Plasma::Types::CustomPanelContainment)) {
-            return containment->lastScreen();
-        }
+    //! screenExists checks if the lastScreen refers to a screen that exists/it's known
+    if (m_screenPool->screenExists(containment->lastScreen()) &&
+            (containment->activity() == m_activityConsumer->currentActivity() ||
+             containment->containmentType() == Plasma::Types::PanelContainment || containment->containmentType() == Plasma::Types::CustomPanelContainment)) {
+        return containment->lastScreen();
     }
 
     return -1;
@@ -945,24 +1145,52 @@ void Corona::loadDefaultLayout()
     addViewForLayout(m_layoutsManager->currentLayoutName());
 }
 
-QStringList Corona::containmentsIds()
+void Corona::trackIds(Plasma::Containment *containment)
 {
-    QStringList ids;
+    if (!containment) {
+        return;
+    }
 
-    for(const auto containment : containments()) {
-        ids << QString::number(containment->id());
+    trackId(containment);
+
+    for (const auto applet : containment->applets()) {
+        trackId(applet);
     }
 
-    return ids;
+    connect(containment, &Plasma::Containment::appletAdded, this, &Corona::trackId, Qt::UniqueConnection);
 }
 
-QStringList Corona::appletsIds()
+void Corona::trackId(Plasma::Applet *applet)
 {
-    QStringList ids;
+    const uint id = applet->id();
 
-    for(const auto containment : containments()) {
-        auto applets = containment->config().group("Applets");
-        ids << applets.groupList();
+    if (m_usedIds.count(id) > 0) {
+        return;
+    }
+
+    m_usedIds.insert(id);
+
+    connect(applet, &QObject::destroyed, this, [this, id]() {
+        m_usedIds.erase(id);
+    });
+}
+
+QList<uint> Corona::availableIds(int count, uint base, const QSet<uint> &reserved) const
+{
+    QList<uint> ids;
+    auto used = m_usedIds.lower_bound(base);
+
+    for (uint id = base; ids.count() < count && id < MAXIMUMID; ++id) {
+        //! used ids are sorted so they are walked only once
+        while (used != m_usedIds.end() && *used < id) {
+            ++used;
+        }
+
+        if ((used != m_usedIds.end() && *used == id) || reserved.contains(id)) {
+            continue;
+        }
+
+        ids << id;
     }
 
     return ids;
@@ -27,9 +27,17 @@
 #include "../liblatte2/types.h"
 
 // Qt
+#include <QElapsedTimer>
+#include <QHash>
 #include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QScreen>
 #include <QTimer>
 
+// C++
+#include <set>
+
 // Plasma
 #include <Plasma/Corona>
 
@@ -41,6 +49,7 @@ class QmlObjectSharedEngine;
 }
 
 namespace Plasma {
+class Applet;
 class Corona;
 class Containment;
 class Types;
@@ -113,6 +122,14 @@ public:
 
     QRegion availableScreenRegionWithCriteria(int id, QString forLayout = QString()) const;
 
+    //! available screen geometries are cached per screen/layout/criteria. This is used
+    //! in order to invalidate silently the ones that the view is affecting, it is needed
+    //! for changes that do not require to notify other views
+    void invalidateAvailableScreenCache(Latte::View *view);
+    //! it is used for changes that may affect only the available screen region, the cached
+    //! geometries are recalculated and notifications are sent only when they changed
+    void updateAvailableScreenCache(Latte::View *view);
+
     int screenForContainment(const Plasma::Containment *containment) const override;
 
     void closeApplication();
@@ -151,6 +168,7 @@ public slots:
     void windowColorScheme(QString windowIdAndScheme);
     void updateDockItemBadge(QString identifier, QString value);
 
+    void resetAvailableScreenCache();
     void unload();
 
 signals:
@@ -159,20 +177,30 @@ signals:
     void raiseViewsTemporaryChanged();
     void availableScreenRectChangedFrom(Latte::View *origin);
     void availableScreenRegionChangedFrom(Latte::View *origin);
+    //! it is sent only for screens whose available geometries were invalidated,
+    //! origin is the view that caused it, null for screens or layouts changes
+    void availableScreenRectChangedOn(QScreen *screen, Latte::View *origin);
 
 private slots:
     void alternativesVisibilityChanged(bool visible);
     void load();
 
     void addOutput(QScreen *screen);
+    void availableScreenChangedFrom(Latte::View *origin);
     void primaryOutputChanged();
     void screenRemoved(QScreen *screen);
     void screenCountChanged();
     void syncLatteViewsToScreens();
 
+    void trackIds(Plasma::Containment *containment);
+    void trackId(Plasma::Applet *applet);
+
 private:
     void cleanConfig();
     void qmlRegisterTypes() const;
+    void scheduleViewsScreenSync();
+    void trackScreensChangedViews();
+    void screensChangedViewShown(const Latte::View *view);
     void setupWaylandIntegration();
 
     bool appletExists(uint containmentId, uint appletId) const;
@@ -180,8 +208,13 @@ private:
 
     int primaryScreenId() const;
 
-    QStringList containmentsIds();
-    QStringList appletsIds();
+    QScreen *screenForId(int id) const;
+    QList<QScreen *> viewAffectedScreens(Latte::View *view);
+    void invalidateAvailableScreenCacheOn(QScreen *screen);
+
+    //! provides count unused containment/applet ids starting from base,
+    //! the reserved ones are skipped as well
+    QList<uint> availableIds(int count, uint base, const QSet<uint> &reserved = QSet<uint>()) const;
 
     bool m_activitiesStarting{true};
     bool m_defaultLayoutOnStartup{false}; //! this is used to enforce loading the default layout on startup
@@ -194,11 +227,34 @@ private:
 
     QString m_layoutNameOnStartUp;
 
+    //! ids of all loaded containments and applets, it is kept sorted in order
+    //! to provide unique ids for copied and imported layouts fast
+    std::set<uint> m_usedIds;
+
     QList<KDeclarative::QmlObjectSharedEngine *> m_alternativesObjects;
 
     KDeclarative::QmlObjectSharedEngine *m_backgroundTracer;
 
     QTimer m_viewsScreenSyncTimer;
+    //! measures the latency from a screen event until the affected views are shown
+    QElapsedTimer m_screensChangedTime;
+    //! views that were added or moved because of the last screens change
+    //! and have not shown their window yet
+    QList<const Latte::View *> m_screensChangedViews;
+    QList<QMetaObject::Connection> m_screensChangedConnections;
+
+    //! cached results of available screen calculations for a screen id
+    struct AvailableScreenCache {
+        QScreen *screen{nullptr};
+        //! layout name -> free region
+        QHash<QString, QRegion> regions;
+        //! layout name and criteria -> free rectangle
+        QHash<QString, QRect> rects;
+    };
+
+    mutable QHash<int, AvailableScreenCache> m_availableScreenCache;
+    //! the last screen that each view affected
+    QHash<const Latte::View *, QPointer<QScreen>> m_viewScreens;
 
     KActivities::Consumer *m_activityConsumer;
     QPointer<KAboutApplicationDialog> aboutDialog;
@@ -30,6 +30,7 @@
 #include "../shortcuts/shortcutstracker.h"
 #include "../view/view.h"
 #include "../view/positioner.h"
+#include "../view/visibilitymanager.h"
 
 // Qt
 #include <QDebug>
@@ -50,6 +51,17 @@ GenericLayout::GenericLayout(QObject *parent, QString layoutFile, QString assign
     : AbstractLayout (parent, layoutFile, assignedName),
       m_storage(new Storage(this))
 {
+    m_geometriesSyncTimer.setSingleShot(true);
+    m_geometriesSyncTimer.setInterval(0);
+    connect(&m_geometriesSyncTimer, &QTimer::timeout, this, &GenericLayout::syncGeometries);
+
+    m_strutsCommitTimer.setSingleShot(true);
+    m_strutsCommitTimer.setInterval(0);
+    connect(&m_strutsCommitTimer, &QTimer::timeout, this, &GenericLayout::commitStruts);
+
+    m_viewsCreationTimer.setSingleShot(true);
+    m_viewsCreationTimer.setInterval(0);
+    connect(&m_viewsCreationTimer, &QTimer::timeout, this, &GenericLayout::createQueuedView);
 }
 
 GenericLayout::~GenericLayout()
@@ -68,6 +80,7 @@ void GenericLayout::unloadContainments()
     }
 
     //!disconnect signals in order to avoid crashes when the layout is unloading
+    disconnect(this, &GenericLayout::viewsCountChanged, m_corona, &Latte::Corona::resetAvailableScreenCache);
     disconnect(this, &GenericLayout::viewsCountChanged, m_corona, &Plasma::Corona::availableScreenRectChanged);
     disconnect(this, &GenericLayout::viewsCountChanged, m_corona, &Plasma::Corona::availableScreenRegionChanged);
     disconnect(m_corona->activityConsumer(), &KActivities::Consumer::currentActivityChanged, this, &GenericLayout::updateLastUsedActivity);
@@ -119,6 +132,9 @@ void GenericLayout::unloadLatteViews()
 
     qDebug() << "Layout - " + name() + " unload: latteViews ... size: " << m_latteViews.size();
 
+    m_viewsCreationTimer.stop();
+    m_viewsCreationQueue.clear();
+
     qDeleteAll(m_latteViews);
     qDeleteAll(m_waitingLatteViews);
     m_latteViews.clear();
@@ -163,6 +179,27 @@ bool GenericLayout::isCurrent() const
     return name() == m_corona->layoutsManager()->currentLayoutName();
 }
 
+bool GenericLayout::isOnStandby() const
+{
+    return m_onStandby;
+}
+
+void GenericLayout::setOnStandby(bool standby)
+{
+    if (m_onStandby == standby) {
+        return;
+    }
+
+    m_onStandby = standby;
+
+    //! views that were still queued are created when the layout is activated again
+    if (!m_onStandby && !m_viewsCreationQueue.isEmpty()) {
+        m_viewsCreationTimer.start();
+    }
+
+    emit onStandbyChanged();
+}
+
 int GenericLayout::viewsCount(int screen) const
 {
     if (!m_corona) {
@@ -199,6 +236,11 @@ int GenericLayout::viewsCount(QScreen *screen) const
     return views;
 }
 
+int GenericLayout::avoidedSyncRounds() const
+{
+    return m_avoidedSyncRounds;
+}
+
 int GenericLayout::viewsCount() const
 {
     if (!m_corona) {
@@ -311,6 +353,97 @@ Types::ViewType GenericLayout::latteViewType(int containmentId) const
     return Types::DockView;
 }
 
+void GenericLayout::scheduleGeometriesSync(QScreen *screen)
+{
+    if (!screen) {
+        return;
+    }
+
+    //! when a pass is running, vertical views are already synchronized in order and their
+    //! changes do not affect each other because only horizontal views occupy screen regions
+    if (m_inGeometriesSync || m_geometriesSyncScreens.contains(screen)) {
+        ++m_avoidedSyncRounds;
+        emit avoidedSyncRoundsChanged();
+        return;
+    }
+
+    m_geometriesSyncScreens << screen;
+    m_geometriesSyncTimer.start();
+}
+
+void GenericLayout::syncGeometries()
+{
+    if (!m_corona || m_geometriesSyncScreens.isEmpty()) {
+        return;
+    }
+
+    QList<QPointer<QScreen>> screens = m_geometriesSyncScreens;
+    m_geometriesSyncScreens.clear();
+
+    m_inGeometriesSync = true;
+
+    for (const auto view : sortedLatteViews()) {
+        if (view && !view->inDelete() && view->formFactor() == Plasma::Types::Vertical
+                && screens.contains(view->screen())) {
+            view->positioner()->syncGeometry();
+        }
+    }
+
+    m_inGeometriesSync = false;
+}
+
+void GenericLayout::scheduleStrutsCommit(Latte::View *view)
+{
+    if (!view || m_strutsCommitViews.contains(view)) {
+        return;
+    }
+
+    m_strutsCommitViews << view;
+    m_strutsCommitTimer.start();
+}
+
+void GenericLayout::queueView(Plasma::Containment *containment)
+{
+    if (m_viewsCreationQueue.isEmpty()) {
+        m_viewsCreationTime.start();
+    }
+
+    m_viewsCreationQueue << containment;
+    m_viewsCreationTimer.start();
+}
+
+void GenericLayout::createQueuedView()
+{
+    if (m_onStandby || m_viewsCreationQueue.isEmpty()) {
+        return;
+    }
+
+    QPointer<Plasma::Containment> containment = m_viewsCreationQueue.takeFirst();
+
+    //! containments that were removed meanwhile or got their view otherwise are ignored
+    if (containment && m_containments.contains(containment) && !m_latteViews.contains(containment)) {
+        addView(containment);
+    }
+
+    if (!m_viewsCreationQueue.isEmpty()) {
+        m_viewsCreationTimer.start();
+    } else {
+        qDebug() << "Layout :::: " << m_layoutName << " ::: queued views created in :: " << m_viewsCreationTime.elapsed() << "ms";
+    }
+}
+
+void GenericLayout::commitStruts()
+{
+    QList<QPointer<Latte::View>> views = m_strutsCommitViews;
+    m_strutsCommitViews.clear();
+
+    for (const auto &view : views) {
+        if (view && !view->inDelete() && view->visibility()) {
+            view->visibility()->commitStruts();
+        }
+    }
+}
+
 Latte::View *GenericLayout::highestPriorityView()
 {
     QList<Latte::View *> views = sortedLatteViews();
@@ -528,12 +661,13 @@ void GenericLayout::addContainment(Plasma::Containment *containment)
 
     if (containmentInLayout) {
         if (!blockAutomaticLatteViewCreation()) {
-            addView(containment);
+            queueView(containment);
         } else {
             qDebug() << "delaying LatteView creation for containment :: " << containment->id();
         }
 
         connect(containment, &QObject::destroyed, this, &GenericLayout::containmentDestroyed);
+        m_storage->trackContainment(containment);
     }
 }
 
@@ -757,6 +891,9 @@ void GenericLayout::addView(Plasma::Containment *containment, bool forceOnPrimar
         byPassWM = containment->config().readEntry("byPassWM", false);
     }
 
+    QElapsedTimer instantiateTime;
+    instantiateTime.start();
+
     auto latteView = new Latte::View(m_corona, nextScreen, byPassWM);
 
     latteView->init();
@@ -778,6 +915,9 @@ void GenericLayout::addView(Plasma::Containment *containment, bool forceOnPrimar
     latteView->show();
     //}
 
+    qDebug() << "Layout :::: " << m_layoutName << " ::: view for containment :: " << containment->id()
+             << " instantiated in :: " << instantiateTime.elapsed() << "ms";
+
     m_latteViews[containment] = latteView;
 
     emit viewsCountChanged();
@@ -815,6 +955,7 @@ bool GenericLayout::initToCorona(Latte::Corona *corona)
     connect(m_corona, &Plasma::Corona::containmentAdded, this, &GenericLayout::addContainment);
 
     //!connect signals after adding the containment
+    connect(this, &GenericLayout::viewsCountChanged, m_corona, &Latte::Corona::resetAvailableScreenCache);
     connect(this, &GenericLayout::viewsCountChanged, m_corona, &Plasma::Corona::availableScreenRectChanged);
     connect(this, &GenericLayout::viewsCountChanged, m_corona, &Plasma::Corona::availableScreenRegionChanged);
 
@@ -866,6 +1007,8 @@ void GenericLayout::assignToLayout(Latte::View *latteView, QList<Plasma::Contain
                 connect(containment, &Plasma::Applet::destroyedChanged, this, &GenericLayout::destroyedChanged);
                 connect(containment, &Plasma::Containment::appletCreated, this, &GenericLayout::appletCreated);
             }
+
+            m_storage->trackContainment(containment);
         }
 
         latteView->setLayout(this);
@@ -905,6 +1048,7 @@ QList<Plasma::Containment *> GenericLayout::unassignFromLayout(Latte::View *latt
 
     for (const auto containment : containments) {
         m_containments.removeAll(containment);
+        m_storage->untrackContainment(containment);
     }
 
     if (containments.size() > 0) {
@@ -25,10 +25,12 @@
 #include "../../liblatte2/types.h"
 
 // Qt
+#include <QElapsedTimer>
 #include <QObject>
 #include <QQuickView>
 #include <QPointer>
 #include <QScreen>
+#include <QTimer>
 
 // Plasma
 #include <Plasma>
@@ -61,6 +63,8 @@ class GenericLayout : public AbstractLayout
 {
     Q_OBJECT
     Q_PROPERTY(int viewsCount READ viewsCount NOTIFY viewsCountChanged)
+    //! geometry synchronization rounds that were merged into a single screen pass
+    Q_PROPERTY(int avoidedSyncRounds READ avoidedSyncRounds NOTIFY avoidedSyncRoundsChanged)
 
 public:   
     GenericLayout(QObject *parent, QString layoutFile, QString assignedName = QString());
@@ -73,6 +77,10 @@ public:
 
     bool isActive() const; //! is loaded and running
     virtual bool isCurrent() const;
+    //! layouts on standby are not active but they keep their containments and
+    //! views loaded and hidden, in order to be activated again without recreating them
+    bool isOnStandby() const;
+    void setOnStandby(bool standby);
     bool isWritable() const;
     bool layoutIsBroken() const;
 
@@ -80,6 +88,8 @@ public:
     virtual int viewsCount(QScreen *screen) const;
     virtual int viewsCount() const;
 
+    int avoidedSyncRounds() const;
+
     Type type() const override;
 
     Latte::Corona *corona();
@@ -128,6 +138,14 @@ public:
     //! that latteView
     QList<Plasma::Containment *> unassignFromLayout(Latte::View *latteView);
 
+    //! vertical views geometries in a screen are synchronized together in one pass
+    //! ordered by their priority instead of each view reacting on its own
+    void scheduleGeometriesSync(QScreen *screen);
+
+    //! struts of all views are committed together in order for the window manager
+    //! to relayout maximized windows once
+    void scheduleStrutsCommit(Latte::View *view);
+
 public slots:
     Q_INVOKABLE void addNewView();
     Q_INVOKABLE int viewsWithTasks() const;
@@ -135,6 +153,8 @@ public slots:
 
 signals:
     void activitiesChanged(); // to move at an interface
+    void avoidedSyncRoundsChanged();
+    void onStandbyChanged();
     void viewsCountChanged();
     void viewEdgeChanged();
 
@@ -161,6 +181,9 @@ private slots:
     void appletCreated(Plasma::Applet *applet);
     void destroyedChanged(bool destroyed);
     void containmentDestroyed(QObject *cont);
+    void syncGeometries();
+    void commitStruts();
+    void createQueuedView();
 
 private:
     //! It can be used in order for LatteViews to not be created automatically when
@@ -176,8 +199,16 @@ private:
 
     bool mapContainsId(const ViewsMap *map, uint viewId) const;
 
+    //! views of loaded containments are created one at a time from the event loop
+    //! so the first docks are shown before the rest are instantiated
+    void queueView(Plasma::Containment *containment);
+
 private:
     bool m_blockAutomaticLatteViewCreation{false};
+    bool m_inGeometriesSync{false};
+    bool m_onStandby{false};
+
+    int m_avoidedSyncRounds{0};
 
     QPointer<Latte::View> m_lastConfigViewFor;
 
@@ -185,6 +216,17 @@ private:
 
     QPointer<Storage> m_storage;
 
+    QTimer m_geometriesSyncTimer;
+    QList<QPointer<QScreen>> m_geometriesSyncScreens;
+
+    QTimer m_strutsCommitTimer;
+    QList<QPointer<Latte::View>> m_strutsCommitViews;
+
+    QTimer m_viewsCreationTimer;
+    QList<QPointer<Plasma::Containment>> m_viewsCreationQueue;
+    //! measures how long it takes for all queued views to be created
+    QElapsedTimer m_viewsCreationTime;
+
     //! try to avoid crashes from recreating the same views all the time
     QList<const Plasma::Containment *> m_viewsToRecreate;
 
@@ -26,7 +26,7 @@
 #include "../layouts/importer.h"
 #include "../view/view.h"
 // Qt
-#include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 
@@ -103,42 +103,25 @@ void Storage::importToCorona()
     //! Setting mutable for create a containment
     m_layout->corona()->setImmutability(Plasma::Types::Mutable);
 
-    QString temp1FilePath = QDir::homePath() + "/.config/lattedock.copy1.bak";
-    //! we need to copy first the layout file because the kde cache
-    //! may not have yet been updated (KSharedConfigPtr)
+    //! the layout file is read directly instead of through the kde cache
+    //! because the cache (KSharedConfigPtr) may not have yet been updated.
     //! this way we make sure at the latest changes stored in the layout file
     //! will be also available when changing to Multiple Layouts
-    QString tempLayoutFilePath = QDir::homePath() + "/.config/lattedock.layout.bak";
+    KConfig layoutFile(m_layout->file(), KConfig::SimpleConfig);
 
-    //! WE NEED A WAY TO COPY A CONTAINMENT!!!!
-    QFile tempLayoutFile(tempLayoutFilePath);
-    QFile copyFile(temp1FilePath);
-    QFile layoutOriginalFile(m_layout->file());
-
-    if (tempLayoutFile.exists()) {
-        tempLayoutFile.remove();
-    }
-
-    if (copyFile.exists())
-        copyFile.remove();
-
-    layoutOriginalFile.copy(tempLayoutFilePath);
-
-    KSharedConfigPtr filePtr = KSharedConfig::openConfig(tempLayoutFilePath);
-    KSharedConfigPtr newFile = KSharedConfig::openConfig(temp1FilePath);
-    KConfigGroup copyGroup = KConfigGroup(newFile, "Containments");
-    KConfigGroup current_containments = KConfigGroup(filePtr, "Containments");
+    //! configs without a file name are kept only in memory
+    KConfig copied(QString(), KConfig::SimpleConfig);
+    KConfigGroup copyGroup = KConfigGroup(&copied, "Containments");
+    KConfigGroup current_containments = KConfigGroup(&layoutFile, "Containments");
 
     current_containments.copyTo(&copyGroup);
 
-    copyGroup.sync();
-
     //! update ids to unique ones
-    QString temp2File = newUniqueIdsLayoutFromFile(temp1FilePath);
-
+    KConfig uniqueIdsLayout(QString(), KConfig::SimpleConfig);
+    newUniqueIdsLayout(&copied, &uniqueIdsLayout);
 
     //! Finally import the configuration
-    importLayoutFile(temp2File);
+    importLayout(&uniqueIdsLayout);
 }
 
 void Storage::syncToLayoutFile(bool removeLayoutId)
@@ -147,29 +130,143 @@ void Storage::syncToLayoutFile(bool removeLayoutId)
         return;
     }
 
-    KSharedConfigPtr filePtr = KSharedConfig::openConfig(m_layout->file());
+    QElapsedTimer syncTime;
+    syncTime.start();
 
-    KConfigGroup oldContainments = KConfigGroup(filePtr, "Containments");
-    oldContainments.deleteGroup();
-    oldContainments.sync();
+    KSharedConfigPtr filePtr = KSharedConfig::openConfig(m_layout->file());
+    KConfigGroup fileContainments = KConfigGroup(filePtr, "Containments");
 
     qDebug() << " LAYOUT :: " << m_layout->name() << " is syncing its original file.";
 
+    QStringList containmentIds;
+    int rewritten{0};
+    int removed{0};
+
     for (const auto containment : *m_layout->containments()) {
         if (removeLayoutId) {
             containment->config().writeEntry("layoutId", "");
         }
 
-        KConfigGroup newGroup = oldContainments.group(QString::number(containment->id()));
+        QString cId = QString::number(containment->id());
+        containmentIds << cId;
+
+        //! containments can also be changed directly from their config, so the clean
+        //! ones are still compared with their stored group, that comparison is done in memory
+        if (!m_dirtyContainments.contains(containment->id())
+                && groupsAreEqual(containment->config(), fileContainments.group(cId), true)) {
+            continue;
+        }
+
+        fileContainments.group(cId).deleteGroup();
+
+        KConfigGroup newGroup = fileContainments.group(cId);
         containment->config().copyTo(&newGroup);
+        newGroup.writeEntry("layoutId", "");
+
+        rewritten++;
+    }
+
+    //! remove containments that do not exist any more
+    for (const auto &cId : fileContainments.groupList()) {
+        if (!containmentIds.contains(cId)) {
+            fileContainments.group(cId).deleteGroup();
+            removed++;
+        }
+    }
+
+    m_dirtyContainments.clear();
+
+    if (rewritten == 0 && removed == 0) {
+        qDebug() << " LAYOUT :: " << m_layout->name() << " original file is already synced :: " << syncTime.elapsed() << "ms";
+        return;
+    }
+
+    //! KConfig writes the file atomically through QSaveFile
+    filePtr->sync();
+
+    qDebug() << " LAYOUT :: " << m_layout->name() << " synced containments, rewritten:" << rewritten << " removed:" << removed
+             << " bytes:" << QFileInfo(m_layout->file()).size() << " time:" << syncTime.elapsed() << "ms";
+}
+
+void Storage::trackContainment(Plasma::Containment *containment)
+{
+    if (!containment) {
+        return;
+    }
+
+    const uint cId = containment->id();
+
+    auto setDirty = [this, cId]() {
+        m_dirtyContainments << cId;
+    };
+
+    auto trackApplet = [this, setDirty](Plasma::Applet *applet) {
+        connect(applet, &Plasma::Applet::configNeedsSaving, this, setDirty);
+    };
+
+    connect(containment, &Plasma::Containment::configNeedsSaving, this, setDirty);
+    connect(containment, &Plasma::Containment::locationChanged, this, setDirty);
+    connect(containment, &Plasma::Containment::appletRemoved, this, setDirty);
+    connect(containment, &Plasma::Containment::appletAdded, this, [setDirty, trackApplet](Plasma::Applet *applet) {
+        setDirty();
+        trackApplet(applet);
+    });
+
+    for (const auto applet : containment->applets()) {
+        trackApplet(applet);
+    }
+}
+
+void Storage::untrackContainment(Plasma::Containment *containment)
+{
+    if (!containment) {
+        return;
+    }
+
+    disconnect(containment, nullptr, this, nullptr);
+
+    for (const auto applet : containment->applets()) {
+        disconnect(applet, nullptr, this, nullptr);
+    }
+
+    m_dirtyContainments.remove(containment->id());
+}
 
-        if (!removeLayoutId) {
-            newGroup.writeEntry("layoutId", "");
-            newGroup.sync();
+bool Storage::groupsAreEqual(const KConfigGroup &group1, const KConfigGroup &group2, bool ignoreLayoutId)
+{
+    QMap<QString, QString> entries1 = group1.entryMap();
+    QMap<QString, QString> entries2 = group2.entryMap();
+
+    if (ignoreLayoutId) {
+        //! layoutId is always stored empty in layout files
+        if (!entries2.value("layoutId").isEmpty()) {
+            return false;
         }
+
+        entries1.remove("layoutId");
+        entries2.remove("layoutId");
     }
 
-    oldContainments.sync();
+    if (entries1 != entries2) {
+        return false;
+    }
+
+    QStringList groups1 = group1.groupList();
+    QStringList groups2 = group2.groupList();
+    groups1.sort();
+    groups2.sort();
+
+    if (groups1 != groups2) {
+        return false;
+    }
+
+    for (const auto &group : groups1) {
+        if (!groupsAreEqual(group1.group(group), group2.group(group), false)) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 void Storage::copyView(Plasma::Containment *containment)
@@ -181,16 +278,9 @@ void Storage::copyView(Plasma::Containment *containment)
     //! Setting mutable for create a containment
     m_layout->corona()->setImmutability(Plasma::Types::Mutable);
 
-    QString temp1File = QDir::homePath() + "/.config/lattedock.copy1.bak";
-
-    //! WE NEED A WAY TO COPY A CONTAINMENT!!!!
-    QFile copyFile(temp1File);
-
-    if (copyFile.exists())
-        copyFile.remove();
-
-    KSharedConfigPtr newFile = KSharedConfig::openConfig(temp1File);
-    KConfigGroup copied_conts = KConfigGroup(newFile, "Containments");
+    //! configs without a file name are kept only in memory
+    KConfig copied(QString(), KConfig::SimpleConfig);
+    KConfigGroup copied_conts = KConfigGroup(&copied, "Containments");
     KConfigGroup copied_c1 = KConfigGroup(&copied_conts, QString::number(containment->id()));
     KConfigGroup copied_systray;
 
@@ -237,14 +327,14 @@ void Storage::copyView(Plasma::Containment *containment)
     //! end of systray specific code
 
     //! update ids to unique ones
-    QString temp2File = newUniqueIdsLayoutFromFile(temp1File);
-
+    KConfig uniqueIdsLayout(QString(), KConfig::SimpleConfig);
+    newUniqueIdsLayout(&copied, &uniqueIdsLayout);
 
     //! Don't create LatteView when the containment is created because we must update
     //! its screen settings first
     m_layout->setBlockAutomaticLatteViewCreation(true);
     //! Finally import the configuration
-    QList<Plasma::Containment *> importedDocks = importLayoutFile(temp2File);
+    QList<Plasma::Containment *> importedDocks = importLayout(&uniqueIdsLayout);
 
     Plasma::Containment *newContainment{nullptr};
 
@@ -323,10 +413,9 @@ void Storage::copyView(Plasma::Containment *containment)
     m_layout->setBlockAutomaticLatteViewCreation(false);
 }
 
-QList<Plasma::Containment *> Storage::importLayoutFile(QString file)
+QList<Plasma::Containment *> Storage::importLayout(KConfig *layout)
 {
-    KSharedConfigPtr filePtr = KSharedConfig::openConfig(file);
-    auto newContainments = m_layout->corona()->importLayout(KConfigGroup(filePtr, ""));
+    auto newContainments = m_layout->corona()->importLayout(KConfigGroup(layout, ""));
 
     ///Find latte and systray containments
     qDebug() << " imported containments ::: " << newContainments.length();
@@ -344,43 +433,13 @@ QList<Plasma::Containment *> Storage::importLayoutFile(QString file)
     return importedDocks;
 }
 
-QString Storage::availableId(QStringList all, QStringList assigned, int base)
-{
-    bool found = false;
-
-    int i = base;
-
-    while (!found && i < 32000) {
-        QString iStr = QString::number(i);
-
-        if (!all.contains(iStr) && !assigned.contains(iStr)) {
-            return iStr;
-        }
-
-        i++;
-    }
-
-    return QString("");
-}
-
-QString Storage::newUniqueIdsLayoutFromFile(QString file)
+void Storage::newUniqueIdsLayout(KConfig *layout, KConfig *uniqueIdsLayout)
 {
     if (!m_layout->corona()) {
-        return QString();
+        return;
     }
 
-    QString tempFile = QDir::homePath() + "/.config/lattedock.copy2.bak";
-
-    QFile copyFile(tempFile);
-
-    if (copyFile.exists())
-        copyFile.remove();
-
-    //! BEGIN updating the ids in the temp file
-    QStringList allIds;
-    allIds << m_layout->corona()->containmentsIds();
-    allIds << m_layout->corona()->appletsIds();
-
+    //! BEGIN updating the ids in the in-memory layout
     QStringList toInvestigateContainmentIds;
     QStringList toInvestigateAppletIds;
     QStringList toInvestigateSystrayContIds;
@@ -389,16 +448,12 @@ QString Storage::newUniqueIdsLayoutFromFile(QString file)
     QHash<QString, QString> systrayParentContainmentIds;
     QHash<QString, QString> systrayAppletIds;
 
-    //qDebug() << "Ids:" << allIds;
-
     //qDebug() << "to copy containments: " << toCopyContainmentIds;
     //qDebug() << "to copy applets: " << toCopyAppletIds;
 
-    QStringList assignedIds;
     QHash<QString, QString> assigned;
 
-    KSharedConfigPtr filePtr = KSharedConfig::openConfig(file);
-    KConfigGroup investigate_conts = KConfigGroup(filePtr, "Containments");
+    KConfigGroup investigate_conts = KConfigGroup(layout, "Containments");
     //KConfigGroup copied_c1 = KConfigGroup(&copied_conts, QString::number(containment->id()));
 
     //! Record the containment and applet ids
@@ -425,21 +480,19 @@ QString Storage::newUniqueIdsLayoutFromFile(QString file)
     }
 
     //! Reassign containment and applet ids to unique ones
-    for (const auto &contId : toInvestigateContainmentIds) {
-        QString newId = availableId(allIds, assignedIds, 12);
+    QList<uint> newContainmentIds = m_layout->corona()->availableIds(toInvestigateContainmentIds.count(), 12);
 
-        assignedIds << newId;
-        assigned[contId] = newId;
+    for (int i = 0; i < toInvestigateContainmentIds.count(); ++i) {
+        assigned[toInvestigateContainmentIds[i]] = i < newContainmentIds.count() ? QString::number(newContainmentIds[i]) : QString("");
     }
 
-    for (const auto &appId : toInvestigateAppletIds) {
-        QString newId = availableId(allIds, assignedIds, 40);
+    QSet<uint> assignedIds = QSet<uint>::fromList(newContainmentIds);
+    QList<uint> newAppletIds = m_layout->corona()->availableIds(toInvestigateAppletIds.count(), 40, assignedIds);
 
-        assignedIds << newId;
-        assigned[appId] = newId;
+    for (int i = 0; i < toInvestigateAppletIds.count(); ++i) {
+        assigned[toInvestigateAppletIds[i]] = i < newAppletIds.count() ? QString::number(newAppletIds[i]) : QString("");
     }
 
-    qDebug() << "ALL CORONA IDS ::: " << allIds;
     qDebug() << "FULL ASSIGNMENTS ::: " << assigned;
 
     for (const auto &cId : toInvestigateContainmentIds) {
@@ -504,14 +557,10 @@ QString Storage::newUniqueIdsLayoutFromFile(QString file)
     for (const auto &systrayId : toInvestigateSystrayContIds) {
         KConfigGroup systrayParentContainment = investigate_conts.group(systrayParentContainmentIds[systrayId]);
         systrayParentContainment.group("Applets").group(systrayAppletIds[systrayId]).group("Configuration").writeEntry("SystrayContainmentId", assigned[systrayId]);
-        systrayParentContainment.sync();
     }
 
-    investigate_conts.sync();
-
-    //! Copy To Temp 2 File And Update Correctly The Ids
-    KSharedConfigPtr file2Ptr = KSharedConfig::openConfig(tempFile);
-    KConfigGroup fixedNewContainmets = KConfigGroup(file2Ptr, "Containments");
+    //! Copy to the new layout and update correctly the ids
+    KConfigGroup fixedNewContainmets = KConfigGroup(uniqueIdsLayout, "Containments");
 
     for (const auto &contId : investigate_conts.groupList()) {
         QString pluginId = investigate_conts.group(contId).readEntry("plugin", "");
@@ -529,10 +578,6 @@ QString Storage::newUniqueIdsLayoutFromFile(QString file)
             }
         }
     }
-
-    fixedNewContainmets.sync();
-
-    return tempFile;
 }
 
 bool Storage::appletGroupIsValid(KConfigGroup appletGroup)
@@ -24,6 +24,9 @@
 
 // Qt
 #include <QObject>
+#include <QSet>
+
+class KConfig;
 
 namespace Plasma{
 class Containment;
@@ -49,23 +52,34 @@ public:
     void unlock(); //! make it writable which it should be the default
 
     void copyView(Plasma::Containment *containment);
+    //! only containments that changed since the last sync are rewritten, the ones that
+    //! are not marked as changed are still compared with their stored groups
     void syncToLayoutFile(bool removeLayoutId);
+    //! marks the containment as changed when its or its applets config changes
+    void trackContainment(Plasma::Containment *containment);
+    //! it is used when the containment moves to another layout
+    void untrackContainment(Plasma::Containment *containment);
 
     /// STATIC
     //! Check if an applet config group is valid or belongs to removed applet
     static bool appletGroupIsValid(KConfigGroup appletGroup);
 
 private:
+    //! compares recursively the entries of two groups
+    static bool groupsAreEqual(const KConfigGroup &group1, const KConfigGroup &group2, bool ignoreLayoutId);
+
     //! STORAGE !////
-    QString availableId(QStringList all, QStringList assigned, int base);
-    //! provides a new file path based the provided file. The new file
+    //! fills uniqueIdsLayout based on the provided layout. The new layout
     //! has updated ids for containments and applets based on the corona
-    //! loaded ones
-    QString newUniqueIdsLayoutFromFile(QString file);
-    //! imports a layout file and returns the containments for the docks
-    QList<Plasma::Containment *> importLayoutFile(QString file);
+    //! loaded ones. Both are in-memory configs, no temporary files are used
+    void newUniqueIdsLayout(KConfig *layout, KConfig *uniqueIdsLayout);
+    //! imports a layout and returns the containments for the docks
+    QList<Plasma::Containment *> importLayout(KConfig *layout);
 
 private:
+    //! containments whose config changed since the last sync
+    QSet<uint> m_dirtyContainments;
+
     GenericLayout *m_layout;
 };
 
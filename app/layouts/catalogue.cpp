@@ -0,0 +1,136 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "catalogue.h"
+
+// local
+#include "groupreader.h"
+#include "../layout/abstractlayout.h"
+
+// Qt
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+
+// KDE
+#include <KDirWatch>
+
+namespace Latte {
+namespace Layouts {
+
+Catalogue::Catalogue(QObject *parent)
+    : QObject(parent),
+      m_layoutsPath(QDir::homePath() + "/.config/latte")
+{
+    //! track layout files for changes
+    KDirWatch::self()->addDir(m_layoutsPath, KDirWatch::WatchFiles);
+
+    connect(KDirWatch::self(), &KDirWatch::dirty, this, &Catalogue::pathChanged);
+    connect(KDirWatch::self(), &KDirWatch::created, this, &Catalogue::pathChanged);
+    connect(KDirWatch::self(), &KDirWatch::deleted, this, &Catalogue::pathChanged);
+}
+
+Catalogue::~Catalogue()
+{
+    KDirWatch::self()->removeDir(m_layoutsPath);
+}
+
+void Catalogue::pathChanged(const QString &path)
+{
+    if (path == m_layoutsPath) {
+        //! files were added or removed, they are identified in the next scan
+        return;
+    }
+
+    if (path.startsWith(m_layoutsPath) && m_layouts.contains(path)) {
+        m_layouts.remove(path);
+    }
+}
+
+QList<Catalogue::LayoutInfo> Catalogue::layouts()
+{
+    QDir layoutDir(m_layoutsPath);
+    QStringList filter;
+    filter.append(QString("*.layout.latte"));
+    //! only the file system entries are read here, layout files are opened only when they changed
+    QFileInfoList files = layoutDir.entryInfoList(filter, QDir::Files | QDir::NoSymLinks, QDir::Name);
+
+    QList<LayoutInfo> layouts;
+    QSet<QString> paths;
+
+    for (const auto &fileInfo : files) {
+        if (fileInfo.fileName().contains(Layout::AbstractLayout::MultipleLayoutsName)) {
+            //! IMPORTANT: DONT ADD MultipleLayouts hidden file in layouts list
+            continue;
+        }
+
+        const QString path = fileInfo.absoluteFilePath();
+        paths << path;
+
+        if (m_layouts.contains(path)
+                && m_layouts[path].lastModified == fileInfo.lastModified()
+                && m_layouts[path].size == fileInfo.size()) {
+            layouts << m_layouts[path];
+            continue;
+        }
+
+        LayoutInfo info;
+        info.name = Layout::AbstractLayout::layoutName(path);
+        info.file = path;
+        info.lastModified = fileInfo.lastModified();
+        info.size = fileInfo.size();
+
+        if (!readLayoutSettings(path, info)) {
+            qDebug() << "Layouts catalogue could not read layout file :: " << path;
+        }
+
+        m_layouts[path] = info;
+        layouts << info;
+    }
+
+    //! forget layouts that were removed
+    for (const auto &path : m_layouts.keys()) {
+        if (!paths.contains(path)) {
+            m_layouts.remove(path);
+        }
+    }
+
+    return layouts;
+}
+
+bool Catalogue::readLayoutSettings(const QString &file, LayoutInfo &info)
+{
+    QFile layoutFile(file);
+    QHash<QString, QString> entries;
+
+    if (!GroupReader::readGroup(&layoutFile, QStringLiteral("LayoutSettings"), entries)) {
+        return false;
+    }
+
+    info.showInMenu = GroupReader::boolValue(entries.value(QStringLiteral("showInMenu")), false);
+    info.sharedLayoutName = GroupReader::stringValue(entries.value(QStringLiteral("sharedLayout")));
+    info.activities = GroupReader::listValue(entries.value(QStringLiteral("activities")));
+
+    return true;
+}
+
+}
+}
@@ -0,0 +1,75 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LAYOUTSCATALOGUE_H
+#define LAYOUTSCATALOGUE_H
+
+// Qt
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+
+namespace Latte {
+namespace Layouts {
+
+//! Layouts::Catalogue provides the metadata of all stored layouts without
+//! loading them in KConfig. KConfig writes groups sorted by name, so the lines of
+//! the containments and applets groups are still scanned until [LayoutSettings]
+//! is found, but only the entries of that group are parsed. Results are cached
+//! based on the file modification time and size and the layouts directory is
+//! watched in order to keep the cache fresh.
+class Catalogue : public QObject {
+    Q_OBJECT
+
+public:
+    struct LayoutInfo {
+        QString name;
+        QString file;
+        bool showInMenu{false};
+        QString sharedLayoutName;
+        QStringList activities;
+
+        QDateTime lastModified;
+        qint64 size{0};
+    };
+
+    Catalogue(QObject *parent);
+    ~Catalogue() override;
+
+    //! all stored layouts, the hidden MultipleLayouts file is excluded
+    QList<LayoutInfo> layouts();
+
+private slots:
+    void pathChanged(const QString &path);
+
+private:
+    static bool readLayoutSettings(const QString &file, LayoutInfo &info);
+
+private:
+    QString m_layoutsPath;
+
+    //! layout file path -> metadata
+    QHash<QString, LayoutInfo> m_layouts;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,171 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "groupreader.h"
+
+// Qt
+#include <QIODevice>
+#include <QTextStream>
+
+namespace Latte {
+namespace Layouts {
+
+bool GroupReader::readGroup(QIODevice *device, const QString &group, QHash<QString, QString> &entries)
+{
+    if (!device || (!device->isOpen() && !device->open(QIODevice::ReadOnly | QIODevice::Text))) {
+        return false;
+    }
+
+    const QString groupHeader = "[" + group + "]";
+    bool inGroup{false};
+
+    QTextStream stream(device);
+    stream.setCodec("UTF-8");
+
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine().trimmed();
+
+        if (line.startsWith('[')) {
+            if (inGroup) {
+                //! the group ended, the rest of the file is not needed
+                break;
+            }
+
+            inGroup = (line == groupHeader);
+            continue;
+        }
+
+        if (!inGroup || line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        int equal = line.indexOf('=');
+
+        if (equal <= 0) {
+            continue;
+        }
+
+        QString key = line.left(equal).trimmed();
+
+        //! remove options such as [$e] from keys
+        int options = key.indexOf('[');
+
+        if (options > 0) {
+            key = key.left(options).trimmed();
+        }
+
+        entries[key] = line.mid(equal + 1).trimmed();
+    }
+
+    return true;
+}
+
+bool GroupReader::boolValue(const QString &value, bool defaultValue)
+{
+    const QString lower = stringValue(value).toLower();
+
+    if (lower == QLatin1String("true") || lower == QLatin1String("on")
+            || lower == QLatin1String("yes") || lower == QLatin1String("1")) {
+        return true;
+    } else if (lower == QLatin1String("false") || lower == QLatin1String("off")
+               || lower == QLatin1String("no") || lower == QLatin1String("0")) {
+        return false;
+    }
+
+    return defaultValue;
+}
+
+int GroupReader::intValue(const QString &value, int defaultValue)
+{
+    bool ok{false};
+    int result = stringValue(value).toInt(&ok);
+
+    return ok ? result : defaultValue;
+}
+
+QString GroupReader::stringValue(const QString &value)
+{
+    //! reverses the escaping that KConfig applies to values when writing them in ini files
+    QString result;
+    result.reserve(value.length());
+
+    for (int i = 0; i < value.length(); ++i) {
+        if (value[i] != '\\' || i + 1 >= value.length()) {
+            result.append(value[i]);
+            continue;
+        }
+
+        const QChar next = value[++i];
+
+        if (next == 's') {
+            result.append(' ');
+        } else if (next == 't') {
+            result.append('\t');
+        } else if (next == 'n') {
+            result.append('\n');
+        } else if (next == 'r') {
+            result.append('\r');
+        } else if (next == 'x' && i + 2 < value.length()) {
+            bool ok{false};
+            const int code = value.mid(i + 1, 2).toInt(&ok, 16);
+
+            if (ok) {
+                result.append(QChar(code));
+                i += 2;
+            }
+        } else {
+            //! escaped backslashes and list separators
+            result.append(next);
+        }
+    }
+
+    return result;
+}
+
+QStringList GroupReader::listValue(const QString &value)
+{
+    QStringList list;
+
+    if (value.isEmpty()) {
+        return list;
+    }
+
+    //! items are split at the unescaped commas and each one is decoded afterwards
+    QString item;
+
+    for (int i = 0; i < value.length(); ++i) {
+        if (value[i] == '\\' && i + 1 < value.length()) {
+            item.append(value[i]);
+            item.append(value[++i]);
+        } else if (value[i] == ',') {
+            list << stringValue(item);
+            item.clear();
+        } else {
+            item.append(value[i]);
+        }
+    }
+
+    list << stringValue(item);
+
+    return list;
+}
+
+}
+}
@@ -0,0 +1,54 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LAYOUTSGROUPREADER_H
+#define LAYOUTSGROUPREADER_H
+
+// Qt
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+class QIODevice;
+
+namespace Latte {
+namespace Layouts {
+
+//! GroupReader reads the entries of a single group of a KConfig ini file without
+//! loading the whole file in KConfig. Lines are scanned until the group is found and
+//! only its own entries are parsed, reading stops as soon as the group ends.
+//! Values are returned as they are stored and they are decoded through the
+//! provided functions the same way KConfig does.
+class GroupReader
+{
+public:
+    //! returns false when the device can not be read
+    static bool readGroup(QIODevice *device, const QString &group, QHash<QString, QString> &entries);
+
+    static bool boolValue(const QString &value, bool defaultValue = false);
+    static int intValue(const QString &value, int defaultValue = 0);
+    static QString stringValue(const QString &value);
+    static QStringList listValue(const QString &value);
+};
+
+}
+}
+
+#endif
@@ -21,7 +21,9 @@
 #include "importer.h"
 
 // local
+#include "groupreader.h"
 #include "manager.h"
+#include "synchronizer.h"
 #include "../lattecorona.h"
 #include "../screenpool.h"
 #include "../layout/abstractlayout.h"
@@ -29,13 +31,16 @@
 #include "../liblatte2/types.h"
 
 // Qt
+#include <QElapsedTimer>
 #include <QFile>
+#include <QScopedPointer>
 #include <QTemporaryDir>
 
 // KDE
 #include <KArchive/KTar>
 #include <KArchive/KArchiveEntry>
 #include <KArchive/KArchiveDirectory>
+#include <KArchive/KArchiveFile>
 #include <KConfigGroup>
 #include <KLocalizedString>
 #include <KNotification>
@@ -384,25 +389,54 @@ bool Importer::importOldConfiguration(QString oldConfigPath, QString newName)
 
 bool Importer::exportFullConfiguration(QString file)
 {
-    if (QFile::exists(file) && !QFile::remove(file)) {
-        return false;
-    }
+    QElapsedTimer exportTime;
+    exportTime.start();
 
-    KTar archive(file, QStringLiteral("application/x-tar"));
+    //! the archive is written next to the requested file and it replaces that file only
+    //! when it is complete, so a failed export never leaves a truncated archive behind
+    QString partFile(file + ".part");
+    KTar archive(partFile, QStringLiteral("application/x-tar"));
 
     if (!archive.open(QIODevice::WriteOnly)) {
         return false;
     }
 
-    archive.addLocalFile(QString(QDir::homePath() + "/.config/lattedockrc"), QStringLiteral("lattedockrc"));
+    //! active layouts must store their latest changes before they are archived
+    m_manager->synchronizer()->syncActiveLayoutsToOriginalFiles();
 
-    for(const auto &layoutName : availableLayouts()) {
-        archive.addLocalFile(layoutFilePath(layoutName), QString("latte/" + layoutName + ".layout.latte"));
+    const QStringList layouts = availableLayouts();
+    const int total = layouts.count() + 1;
+    int done{0};
+
+    bool archived = archive.addLocalFile(QString(QDir::homePath() + "/.config/lattedockrc"), QStringLiteral("lattedockrc"));
+
+    if (archived) {
+        emit exportProgressChanged(++done, total);
+    }
+
+    for(const auto &layoutName : layouts) {
+        if (!archived) {
+            break;
+        }
+
+        archived = archive.addLocalFile(layoutFilePath(layoutName), QString("latte/" + layoutName + ".layout.latte"));
+
+        if (archived) {
+            emit exportProgressChanged(++done, total);
+        }
     }
 
     //archive.addLocalDirectory(QString(QDir::homePath() + "/.config/latte"), QStringLiteral("latte"));
 
-    archive.close();
+    if (!archive.close() || !archived
+            || (QFile::exists(file) && !QFile::remove(file))
+            || !QFile::rename(partFile, file)) {
+        QFile::remove(partFile);
+        return false;
+    }
+
+    qDebug() << "Full configuration exported, layouts:" << layouts.count() << " bytes:" << QFileInfo(file).size()
+             << " time:" << exportTime.elapsed() << "ms";
 
     return true;
 }
@@ -413,9 +447,8 @@ Importer::LatteFileVersion Importer::fileVersion(QString file)
         return UnknownFileType;
 
     if (file.endsWith(".layout.latte")) {
-        KSharedConfigPtr lConfig = KSharedConfig::openConfig(QFileInfo(file).absoluteFilePath());
-        KConfigGroup layoutGroup = KConfigGroup(lConfig, "LayoutSettings");
-        int version = layoutGroup.readEntry("version", 1);
+        QFile layoutFile(file);
+        int version = configVersion(&layoutFile, QStringLiteral("LayoutSettings"));
 
         if (version == 2)
             return Importer::LayoutVersion2;
@@ -435,8 +468,17 @@ Importer::LatteFileVersion Importer::fileVersion(QString file)
         return Importer::UnknownFileType;
     }
 
-    QTemporaryDir archiveTempDir;
+    return archiveVersion(archive.directory());
+}
+
+Importer::LatteFileVersion Importer::archiveVersion(const KArchiveDirectory *rootDir)
+{
+    if (!rootDir) {
+        return Importer::UnknownFileType;
+    }
 
+    //! only the archive index is used here, the rc files are read in memory
+    //! and nothing is extracted to disk
     bool version1rc = false;
     bool version1applets = false;
 
@@ -444,16 +486,12 @@ Importer::LatteFileVersion Importer::fileVersion(QString file)
     bool version2LatteDir = false;
     bool version2layout = false;
 
-    archive.directory()->copyTo(archiveTempDir.path());
-
-
     //rc file
-    QString rcFile(archiveTempDir.path() + "/lattedockrc");
+    const KArchiveFile *rcFile = rootDir->file(QStringLiteral("lattedockrc"));
 
-    if (QFile(rcFile).exists()) {
-        KSharedConfigPtr lConfig = KSharedConfig::openConfig(rcFile);
-        KConfigGroup universalGroup = KConfigGroup(lConfig, "UniversalSettings");
-        int version = universalGroup.readEntry("version", 1);
+    if (rcFile) {
+        QScopedPointer<QIODevice> rcDevice(rcFile->createDevice());
+        int version = rcDevice ? configVersion(rcDevice.data(), QStringLiteral("UniversalSettings")) : 1;
 
         if (version == 1) {
             version1rc = true;
@@ -463,12 +501,11 @@ Importer::LatteFileVersion Importer::fileVersion(QString file)
     }
 
     //applets file
-    QString appletsFile(archiveTempDir.path() + "/lattedock-appletsrc");
+    const KArchiveFile *appletsFile = rootDir->file(QStringLiteral("lattedock-appletsrc"));
 
-    if (QFile(appletsFile).exists() && version1rc) {
-        KSharedConfigPtr lConfig = KSharedConfig::openConfig(appletsFile);
-        KConfigGroup generalGroup = KConfigGroup(lConfig, "LayoutSettings");
-        int version = generalGroup.readEntry("version", 1);
+    if (appletsFile && version1rc) {
+        QScopedPointer<QIODevice> appletsDevice(appletsFile->createDevice());
+        int version = appletsDevice ? configVersion(appletsDevice.data(), QStringLiteral("LayoutSettings")) : 1;
 
         if (version == 1) {
             version1applets = true;
@@ -478,13 +515,13 @@ Importer::LatteFileVersion Importer::fileVersion(QString file)
     }
 
     //latte directory
-    QString latteDir(archiveTempDir.path() + "/latte");
+    const KArchiveEntry *latteDir = rootDir->entry(QStringLiteral("latte"));
 
-    if (QDir(latteDir).exists()) {
+    if (latteDir && latteDir->isDirectory()) {
         version2LatteDir = true;
     }
 
-    if (version1applets && version1applets) {
+    if (version1rc && version1applets) {
         return ConfigVersion1;
     } else if (version2rc && version2LatteDir) {
         return ConfigVersion2;
@@ -493,11 +530,18 @@ Importer::LatteFileVersion Importer::fileVersion(QString file)
     return Importer::UnknownFileType;
 }
 
-bool Importer::importHelper(QString fileName)
+int Importer::configVersion(QIODevice *device, const QString &group)
 {
-    LatteFileVersion version = fileVersion(fileName);
+    QHash<QString, QString> entries;
+    GroupReader::readGroup(device, group, entries);
 
-    if ((version != ConfigVersion1) && (version != ConfigVersion2)) {
+    //! same default as readEntry("version", 1)
+    return GroupReader::intValue(entries.value(QStringLiteral("version")), 1);
+}
+
+bool Importer::importHelper(QString fileName)
+{
+    if (!QFile::exists(fileName)) {
         return false;
     }
 
@@ -508,14 +552,141 @@ bool Importer::importHelper(QString fileName)
         return false;
     }
 
-    QString latteDirPath(QDir::homePath() + "/.config/latte");
-    QDir latteDir(latteDirPath);
+    //! the same opened archive is used for both its inspection and its extraction
+    LatteFileVersion version = archiveVersion(archive.directory());
+
+    if ((version != ConfigVersion1) && (version != ConfigVersion2)) {
+        return false;
+    }
+
+    QElapsedTimer importTime;
+    importTime.start();
+
+    QString configPath(QDir::homePath() + "/.config");
+    QDir latteDir(configPath + "/latte");
+
+    if (version == ConfigVersion1) {
+        if (latteDir.exists()) {
+            latteDir.removeRecursively();
+        }
+
+        archive.directory()->copyTo(configPath);
+
+        return true;
+    }
+
+    //! layouts are validated and staged next to the current configuration,
+    //! the current configuration is replaced only when all of them were installed
+    QTemporaryDir stagingDir(configPath + "/latte-import-XXXXXX");
+
+    if (!stagingDir.isValid()) {
+        return false;
+    }
+
+    auto archiveLatteDir = static_cast<const KArchiveDirectory *>(archive.directory()->entry(QStringLiteral("latte")));
+    int installed{0};
+
+    for (const auto &name : archiveLatteDir->entries()) {
+        const KArchiveEntry *entry = archiveLatteDir->entry(name);
+        const KArchiveFile *layoutFile = archiveLatteDir->file(name);
+
+        if (!layoutFile || !name.endsWith(".layout.latte")) {
+            //! any other files and directories of the archive are installed as they are
+            bool copied{false};
+
+            if (entry && entry->isDirectory()) {
+                copied = QDir().mkpath(stagingDir.path() + "/" + name)
+                        && static_cast<const KArchiveDirectory *>(entry)->copyTo(stagingDir.path() + "/" + name);
+            } else if (entry && entry->isFile()) {
+                copied = static_cast<const KArchiveFile *>(entry)->copyTo(stagingDir.path());
+            }
+
+            if (!copied) {
+                return false;
+            }
+
+            continue;
+        }
+
+        QScopedPointer<QIODevice> layoutDevice(layoutFile->createDevice());
+
+        if (configVersion(layoutDevice.data(), QStringLiteral("LayoutSettings")) != 2) {
+            qInfo() << i18nc("import/export config", "The layout file has a wrong format and is ignored:") << name;
+            continue;
+        }
+
+        if (!layoutFile->copyTo(stagingDir.path())) {
+            return false;
+        }
+
+        installed++;
+    }
+
+    const KArchiveFile *rcFile = archive.directory()->file(QStringLiteral("lattedockrc"));
+    QString rcPath(configPath + "/lattedockrc");
+    QString stagedRcPath(configPath + "/lattedockrc.import");
+
+    if (!rcFile || !rcFile->copyTo(stagingDir.path())
+            || (QFile::exists(stagedRcPath) && !QFile::remove(stagedRcPath))
+            || !QFile::rename(stagingDir.path() + "/lattedockrc", stagedRcPath)) {
+        return false;
+    }
+
+    //! install the staged configuration, the previous one is restored if that fails.
+    //! The previous latte directory is replaced as a whole, the same way older versions
+    //! were removing it before extracting the archive, so files that exist only there are dropped
+    QString previousLattePath(configPath + "/latte-import-previous");
+    QDir(previousLattePath).removeRecursively();
+
+    //! QTemporaryDir creates private directories, the installed one keeps the usual permissions
+    QFileDevice::Permissions lattePermissions = QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner
+            | QFileDevice::ReadGroup | QFileDevice::ExeGroup
+            | QFileDevice::ReadOther | QFileDevice::ExeOther;
 
     if (latteDir.exists()) {
+        lattePermissions = QFileInfo(latteDir.absolutePath()).permissions();
+    }
+
+    bool previousMoved = latteDir.exists() && QDir().rename(latteDir.absolutePath(), previousLattePath);
+
+    if (!QDir().rename(stagingDir.path(), latteDir.absolutePath())) {
+        if (previousMoved) {
+            QDir().rename(previousLattePath, latteDir.absolutePath());
+        }
+
+        QFile::remove(stagedRcPath);
+        return false;
+    }
+
+    stagingDir.setAutoRemove(false);
+    QFile::setPermissions(latteDir.absolutePath(), lattePermissions);
+
+    //! the previous lattedockrc is kept aside until the staged one is installed
+    QString previousRcPath(configPath + "/lattedockrc.import-previous");
+    QFile::remove(previousRcPath);
+
+    bool previousRcMoved = QFile::exists(rcPath) && QFile::rename(rcPath, previousRcPath);
+
+    if (QFile::exists(rcPath) || !QFile::rename(stagedRcPath, rcPath)) {
+        //! roll back to the previous configuration
+        if (previousRcMoved) {
+            QFile::rename(previousRcPath, rcPath);
+        }
+
         latteDir.removeRecursively();
+
+        if (previousMoved) {
+            QDir().rename(previousLattePath, latteDir.absolutePath());
+        }
+
+        QFile::remove(stagedRcPath);
+        return false;
     }
 
-    archive.directory()->copyTo(QString(QDir::homePath() + "/.config"));
+    QFile::remove(previousRcPath);
+    QDir(previousLattePath).removeRecursively();
+
+    qDebug() << "Full configuration imported, layouts:" << installed << " time:" << importTime.elapsed() << "ms";
 
     return true;
 }
@@ -24,6 +24,9 @@
 // Qt
 #include <QObject>
 
+class KArchiveDirectory;
+class QIODevice;
+
 namespace Latte {
 namespace Layouts {
 class Manager;
@@ -68,6 +71,8 @@ public:
     //!     newName: if it is empty the name is extracted from the old config file name
     bool importOldConfiguration(QString oldConfigPath, QString newName = QString());
 
+    //! the archive is written in one pass from the layout files after the
+    //! active layouts have stored their latest changes
     bool exportFullConfiguration(QString file);
 
     static Importer::LatteFileVersion fileVersion(QString file);
@@ -100,11 +105,20 @@ public:
     //! close correctly, e.g. there was a crash.
     static QStringList checkRepairMultipleLayoutsLinkedFile();
 
+signals:
+    //! reports the archived files during a full configuration export
+    void exportProgressChanged(int done, int total);
+
 private:
     //! checks if this old layout can be imported. If it can it returns
     //! the new layout path and an empty string if it cant
     QString layoutCanBeImported(QString oldAppletsPath, QString newName, QString exportDirectory = QString());
 
+    //! identifies a full configuration archive from its entries and its rc files
+    static Importer::LatteFileVersion archiveVersion(const KArchiveDirectory *rootDir);
+    //! reads the version of a config group and stops reading when that group ends
+    static int configVersion(QIODevice *device, const QString &group);
+
     Layouts::Manager *m_manager;
 };
 
@@ -61,6 +61,7 @@ Manager::Manager(QObject *parent)
         connect(m_synchronizer, &Synchronizer::centralLayoutsChanged, this, &Manager::centralLayoutsChanged);
         connect(m_synchronizer, &Synchronizer::currentLayoutNameChanged, this, &Manager::currentLayoutNameChanged);
         connect(m_synchronizer, &Synchronizer::currentLayoutIsSwitching, this, &Manager::currentLayoutIsSwitching);
+        connect(m_synchronizer, &Synchronizer::layoutIsResuming, this, &Manager::layoutIsResuming);
         connect(m_synchronizer, &Synchronizer::layoutsChanged, this, &Manager::layoutsChanged);
         connect(m_synchronizer, &Synchronizer::menuLayoutsChanged, this, &Manager::menuLayoutsChanged);
     }
@@ -418,6 +419,9 @@ void Manager::importPreset(int presetNo, bool newInstanceIfPresent)
 
 void Manager::showLatteSettingsDialog(int page)
 {
+    //! the settings window edits the files of inactive layouts directly
+    m_synchronizer->unloadStandbyLayouts();
+
     bool created{false};
 
     if (!m_latteSettingsDialog) {
@@ -133,6 +133,7 @@ signals:
     void menuLayoutsChanged();
 
     void currentLayoutIsSwitching(QString layoutName);
+    void layoutIsResuming(QString layoutName);
 
 private:
     void cleanupOnStartup(QString path); //!remove deprecated or oldstyle config options
@@ -20,6 +20,7 @@
 #include "synchronizer.h"
 
 //! local
+#include "catalogue.h"
 #include "importer.h"
 #include "manager.h"
 #include "../lattecorona.h"
@@ -39,22 +40,35 @@
 // KDE
 #include <KActivities/Consumer>
 #include <KActivities/Controller>
+#include <KWindowSystem>
+
+// C
+#include <unistd.h>
 
 namespace Latte {
 namespace Layouts {
 
 Synchronizer::Synchronizer(QObject *parent)
     : QObject(parent),
+      m_catalogue(new Catalogue(this)),
       m_activitiesController(new KActivities::Controller)
 {
     m_manager = qobject_cast<Manager *>(parent);
 
+    //! Activities requests
+    m_activityRequestTimer.setSingleShot(true);
+    connect(&m_activityRequestTimer, &QTimer::timeout, this, &Synchronizer::activityRequestFinished);
+    connect(&m_activityRequestWatcher, &QFutureWatcher<void>::finished, this, &Synchronizer::activityRequestFinished);
+
     //! Dynamic Switching
     m_dynamicSwitchTimer.setSingleShot(true);
     updateDynamicSwitchInterval();
     connect(m_manager->corona()->universalSettings(), &UniversalSettings::showInfoWindowChanged, this, &Synchronizer::updateDynamicSwitchInterval);
     connect(&m_dynamicSwitchTimer, &QTimer::timeout, this, &Synchronizer::confirmDynamicSwitch);
 
+    //! Standby Layouts
+    connect(m_manager->corona()->universalSettings(), &UniversalSettings::standbyLayoutsChanged, this, &Synchronizer::updateStandbyLayouts);
+
     //! KActivities tracking
     connect(m_manager->corona()->activitiesConsumer(), &KActivities::Consumer::currentActivityChanged,
             this, &Synchronizer::currentActivityChanged);
@@ -93,17 +107,7 @@ bool Synchronizer::layoutExists(QString layoutName) const
 
 bool Synchronizer::layoutIsAssigned(QString layoutName)
 {
-    QHashIterator<const QString, QString> i(m_assignedLayouts);
-
-    while (i.hasNext()) {
-        i.next();
-
-        if (i.value() == layoutName) {
-            return true;
-        }
-    }
-
-    return false;
+    return m_assignedLayoutsIndex.contains(layoutName);
 }
 
 bool Synchronizer::mapHasRecord(const QString &record, SharesMap &map)
@@ -125,21 +129,21 @@ bool Synchronizer::registerAtSharedLayout(CentralLayout *central, QString id)
         return false;
     }
 
-    for (int i = 0; i < m_sharedLayouts.size(); ++i) {
-        SharedLayout *layout = m_sharedLayouts.at(i);
+    SharedLayout *shared = sharedLayout(id);
 
-        if (layout->name() == id) {
-            layout->addCentralLayout(central);
-            return true;
-        }
+    if (shared) {
+        shared->addCentralLayout(central);
+        return true;
     }
 
     //! If SharedLayout was not found, we must create it
     SharedLayout *top = new SharedLayout(central, this, Importer::layoutFilePath(id));
     m_sharedLayouts.append(top);
+    updateLayoutsIndex();
     top->importToCorona();
 
     connect(top, &SharedLayout::layoutDestroyed, this, &Synchronizer::unloadSharedLayout);
+    connect(top, &SharedLayout::nameChanged, this, &Synchronizer::updateLayoutsIndex);
 
     return true;
 }
@@ -200,7 +204,7 @@ QStringList Synchronizer::orphanedActivities()
     QStringList orphans;
 
     for (const auto &activity : activities()) {
-        if (m_assignedLayouts[activity].isEmpty()) {
+        if (m_assignedLayouts.value(activity).isEmpty()) {
             orphans.append(activity);
         }
     }
@@ -260,8 +264,10 @@ void Synchronizer::setMenuLayouts(QStringList layouts)
 
 QString Synchronizer::shouldSwitchToLayout(QString activityId)
 {
-    if (m_assignedLayouts.contains(activityId) && m_assignedLayouts[activityId] != currentLayoutName()) {
-        return m_assignedLayouts[activityId];
+    QString assignedLayout = m_assignedLayouts.value(activityId);
+
+    if (m_assignedLayouts.contains(activityId) && assignedLayout != currentLayoutName()) {
+        return assignedLayout;
     } else if (!m_assignedLayouts.contains(activityId) && !m_manager->corona()->universalSettings()->lastNonAssignedLayoutName().isEmpty()
                && m_manager->corona()->universalSettings()->lastNonAssignedLayoutName() != currentLayoutName()) {
         return m_manager->corona()->universalSettings()->lastNonAssignedLayoutName();
@@ -302,16 +308,7 @@ QStringList Synchronizer::validActivities(QStringList currentList)
 
 CentralLayout *Synchronizer::centralLayout(QString id) const
 {
-    for (int i = 0; i < m_centralLayouts.size(); ++i) {
-        CentralLayout *layout = m_centralLayouts.at(i);
-
-        if (layout->name() == id) {
-
-            return layout;
-        }
-    }
-
-    return nullptr;
+    return m_centralLayoutsIndex.value(id, nullptr);
 }
 
 CentralLayout *Synchronizer::currentLayout() const
@@ -319,17 +316,9 @@ CentralLayout *Synchronizer::currentLayout() const
     if (m_manager->memoryUsage() == Types::SingleLayout) {
         return m_centralLayouts.at(0);
     } else {
-        for (auto layout : m_centralLayouts) {
-            if (layout->activities().contains(m_manager->corona()->activitiesConsumer()->currentActivity())) {
-                return layout;
-            }
-        }
+        CentralLayout *layout = m_activitiesIndex.value(m_manager->corona()->activitiesConsumer()->currentActivity(), nullptr);
 
-        for (auto layout : m_centralLayouts) {
-            if (layout->activities().isEmpty()) {
-                return layout;
-            }
-        }
+        return layout ? layout : m_orphansCentralLayout;
     }
 
     return nullptr;
@@ -348,15 +337,7 @@ Layout::GenericLayout *Synchronizer::layout(QString id) const
 
 SharedLayout *Synchronizer::sharedLayout(QString id) const
 {
-    for (int i = 0; i < m_sharedLayouts.size(); ++i) {
-        SharedLayout *layout = m_sharedLayouts.at(i);
-
-        if (layout->name() == id) {
-            return layout;
-        }
-    }
-
-    return nullptr;
+    return m_sharedLayoutsIndex.value(id, nullptr);
 }
 
 Latte::View *Synchronizer::viewForContainment(Plasma::Containment *containment)
@@ -380,10 +361,39 @@ Latte::View *Synchronizer::viewForContainment(Plasma::Containment *containment)
     return nullptr;
 }
 
+QList<Latte::View *> Synchronizer::currentViews()
+{
+    QList<Latte::View *> views;
+
+    //! views of shared layouts are also provided by the central layouts that use them
+    for (auto layout : m_centralLayouts) {
+        for (const auto view : layout->latteViews()) {
+            if (!views.contains(view)) {
+                views << view;
+            }
+        }
+    }
+
+    for (auto layout : m_sharedLayouts) {
+        for (const auto view : layout->latteViews()) {
+            if (!views.contains(view)) {
+                views << view;
+            }
+        }
+    }
+
+    return views;
+}
+
 void Synchronizer::addLayout(CentralLayout *layout)
 {
     if (!m_centralLayouts.contains(layout)) {
         m_centralLayouts.append(layout);
+        updateLayoutsIndex();
+
+        connect(layout, &CentralLayout::activitiesChanged, this, &Synchronizer::updateLayoutsIndex);
+        connect(layout, &CentralLayout::nameChanged, this, &Synchronizer::updateLayoutsIndex);
+
         layout->initToCorona(m_manager->corona());
     }
 }
@@ -413,6 +423,46 @@ void Synchronizer::clearSharedLayoutsFromCentralLists()
     }
 }
 
+void Synchronizer::updateAssignedLayoutsIndex()
+{
+    m_assignedLayoutsIndex.clear();
+
+    for (const auto &layoutName : m_assignedLayouts) {
+        m_assignedLayoutsIndex << layoutName;
+    }
+}
+
+void Synchronizer::updateLayoutsIndex()
+{
+    m_centralLayoutsIndex.clear();
+    m_sharedLayoutsIndex.clear();
+    m_activitiesIndex.clear();
+    m_orphansCentralLayout = nullptr;
+
+    //! the first layout found is used for each key, same as the lists order
+    for (const auto layout : m_centralLayouts) {
+        if (!m_centralLayoutsIndex.contains(layout->name())) {
+            m_centralLayoutsIndex[layout->name()] = layout;
+        }
+
+        for (const auto &activity : layout->activities()) {
+            if (!m_activitiesIndex.contains(activity)) {
+                m_activitiesIndex[activity] = layout;
+            }
+        }
+
+        if (!m_orphansCentralLayout && layout->activities().isEmpty()) {
+            m_orphansCentralLayout = layout;
+        }
+    }
+
+    for (const auto layout : m_sharedLayouts) {
+        if (!m_sharedLayoutsIndex.contains(layout->name())) {
+            m_sharedLayoutsIndex[layout->name()] = layout;
+        }
+    }
+}
+
 void Synchronizer::confirmDynamicSwitch()
 {
     QString tempShouldSwitch = shouldSwitchToLayout(m_manager->corona()->activitiesConsumer()->currentActivity());
@@ -465,16 +515,8 @@ void Synchronizer::pauseLayout(QString layoutName)
         CentralLayout *layout = centralLayout(layoutName);
 
         if (layout && !layout->activities().isEmpty()) {
-            int i = 0;
-
             for (const auto &activityId : layout->activities()) {
-                //! Stopping the activities must be done asynchronous because otherwise
-                //! the activity manager cant close multiple activities
-                QTimer::singleShot(i * 1000, [this, activityId]() {
-                    m_activitiesController->stopActivity(activityId);
-                });
-
-                i = i + 1;
+                requestActivity(activityId, StopActivity);
             }
         }
     }
@@ -487,6 +529,10 @@ void Synchronizer::syncActiveLayoutsToOriginalFiles()
             layout->syncToLayoutFile();
         }
 
+        for (const auto layout : m_standbyLayouts) {
+            layout->syncToLayoutFile();
+        }
+
         for (const auto layout : m_sharedLayouts) {
             layout->syncToLayoutFile();
         }
@@ -509,7 +555,8 @@ void Synchronizer::unloadCentralLayout(CentralLayout *layout)
     int pos = m_centralLayouts.indexOf(layout);
 
     if (pos>=0) {
-        CentralLayout *central = m_centralLayouts.takeAt(0);
+        CentralLayout *central = m_centralLayouts.takeAt(pos);
+        updateLayoutsIndex();
 
         if (m_multipleModeInitialized) {
             central->syncToLayoutFile(true);
@@ -526,12 +573,134 @@ void Synchronizer::unloadCentralLayout(CentralLayout *layout)
     }
 }
 
+bool Synchronizer::putOnStandby(CentralLayout *layout)
+{
+    const int standbyLayouts = m_manager->corona()->universalSettings()->standbyLayouts();
+
+    //! layouts that use a shared layout are always unloaded because their shared views
+    //! are also used by other layouts, views are hidden through X11 windows mapping only
+    if (!m_multipleModeInitialized || standbyLayouts <= 0 || layout->sharedLayout()
+            || !KWindowSystem::isPlatformX11()) {
+        return false;
+    }
+
+    //! when the memory can not be measured the budget is considered exceeded
+    const qint64 memory = residentMemory();
+    const qint64 budget = (qint64)m_manager->corona()->universalSettings()->standbyLayoutsMemory() * 1024 * 1024;
+
+    if (memory < 0 || memory > budget) {
+        qDebug() << "LAYOUT SWITCH ::: standby memory budget exceeded :: " << memory << " / " << budget << " bytes";
+
+        //! the least recently used layout on standby is unloaded, the memory is
+        //! checked again on the next layouts change
+        if (!m_standbyLayouts.isEmpty()) {
+            unloadStandbyLayout(m_standbyLayouts.last());
+        }
+
+        return false;
+    }
+
+    //! the layout file is kept up to date for exports and copies
+    layout->syncToLayoutFile();
+    layout->setOnStandby(true);
+    m_standbyLayouts.prepend(layout);
+
+    updateStandbyLayouts();
+
+    return true;
+}
+
+CentralLayout *Synchronizer::resumeFromStandby(const QString &layoutName)
+{
+    for (int i = 0; i < m_standbyLayouts.count(); ++i) {
+        if (m_standbyLayouts[i]->name() != layoutName) {
+            continue;
+        }
+
+        QElapsedTimer resumeTime;
+        resumeTime.start();
+
+        CentralLayout *layout = m_standbyLayouts.takeAt(i);
+        m_centralLayouts.append(layout);
+        updateLayoutsIndex();
+
+        layout->setOnStandby(false);
+
+        //! screens may have changed while the layout was on standby
+        layout->syncLatteViewsToScreens();
+
+        emit layoutIsResuming(layout->name());
+
+        qDebug() << "LAYOUT SWITCH ::: " << layoutName << " resumed from standby in :: " << resumeTime.elapsed() << "ms";
+
+        return layout;
+    }
+
+    return nullptr;
+}
+
+void Synchronizer::unloadStandbyLayout(CentralLayout *layout)
+{
+    if (!m_standbyLayouts.removeOne(layout)) {
+        return;
+    }
+
+    qDebug() << "REMOVING STANDBY LAYOUT ::::: " << layout->name();
+
+    //! standby layouts exist only in MultipleLayouts mode, the linked file is
+    //! cleared even when the memory usage is changing
+    layout->syncToLayoutFile(true);
+    layout->unloadContainments();
+    layout->unloadLatteViews();
+    m_manager->clearUnloadedContainmentsFromLinkedFile(layout->unloadedContainmentsIds(), true);
+
+    delete layout;
+}
+
+void Synchronizer::unloadStandbyLayouts()
+{
+    while (!m_standbyLayouts.isEmpty()) {
+        unloadStandbyLayout(m_standbyLayouts.last());
+    }
+}
+
+void Synchronizer::updateStandbyLayouts()
+{
+    const int standbyLayouts = qMax(0, m_manager->corona()->universalSettings()->standbyLayouts());
+
+    while (m_standbyLayouts.count() > standbyLayouts) {
+        unloadStandbyLayout(m_standbyLayouts.last());
+    }
+}
+
+qint64 Synchronizer::residentMemory()
+{
+    //! the second field of statm is the resident set size in pages
+    QFile statm(QStringLiteral("/proc/self/statm"));
+
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+
+    if (fields.count() < 2) {
+        return -1;
+    }
+
+    bool ok{false};
+    const qint64 pages = fields[1].toLongLong(&ok);
+
+    return ok ? pages * sysconf(_SC_PAGESIZE) : -1;
+}
+
 void Synchronizer::unloadSharedLayout(SharedLayout *layout)
 {
     if (m_sharedLayouts.contains(layout)) {
         disconnect(layout, &SharedLayout::layoutDestroyed, this, &Synchronizer::unloadSharedLayout);
         int pos = m_sharedLayouts.indexOf(layout);
         SharedLayout *shared = m_sharedLayouts.takeAt(pos);
+        updateLayoutsIndex();
         shared->syncToLayoutFile(true);
         shared->unloadContainments();
         shared->unloadLatteViews();
@@ -544,46 +713,44 @@ void Synchronizer::unloadSharedLayout(SharedLayout *layout)
 
 void Synchronizer::loadLayouts()
 {
+    //! layouts files may have been changed, so layouts on standby are not valid any more
+    unloadStandbyLayouts();
+
     m_layouts.clear();
     m_menuLayouts.clear();
     m_assignedLayouts.clear();
     m_sharedLayoutIds.clear();
 
-    QDir layoutDir(QDir::homePath() + "/.config/latte");
-    QStringList filter;
-    filter.append(QString("*.layout.latte"));
-    QStringList files = layoutDir.entryList(filter, QDir::Files | QDir::NoSymLinks);
+    //! only the layouts metadata are needed, layouts are not loaded here
+    for (const auto &layout : m_catalogue->layouts()) {
+        QStringList validActivityIds = validActivities(layout.activities);
 
-    for (const auto &layout : files) {
-        if (layout.contains(Layout::AbstractLayout::MultipleLayoutsName)) {
-            //! IMPORTANT: DONT ADD MultipleLayouts hidden file in layouts list
-            continue;
+        if (validActivityIds != layout.activities) {
+            //! rare case, the layout file must be updated with the valid activities
+            CentralLayout centralLayout(this, layout.file);
+            centralLayout.setActivities(validActivityIds);
         }
 
-        CentralLayout centralLayout(this, layoutDir.absolutePath() + "/" + layout);
-
-        QStringList validActivityIds = validActivities(centralLayout.activities());
-        centralLayout.setActivities(validActivityIds);
-
         for (const auto &activity : validActivityIds) {
-            m_assignedLayouts[activity] = centralLayout.name();
+            m_assignedLayouts[activity] = layout.name;
         }
 
-        m_layouts.append(centralLayout.name());
+        m_layouts.append(layout.name);
 
-        if (centralLayout.showInMenu()) {
-            m_menuLayouts.append(centralLayout.name());
+        if (layout.showInMenu) {
+            m_menuLayouts.append(layout.name);
         }
 
-        QString sharedName = centralLayout.sharedLayoutName();
+        QString sharedName = layout.sharedLayoutName;
 
-        if (!sharedName.isEmpty() && !m_sharedLayoutIds.contains(sharedName)) {
+        if (!sharedName.isEmpty() && Importer::layoutExists(sharedName) && !m_sharedLayoutIds.contains(sharedName)) {
             m_sharedLayoutIds << sharedName;
         }
     }
 
     //! Shared Layouts should not be used for Activities->Layouts assignments or published lists
     clearSharedLayoutsFromCentralLists();
+    updateAssignedLayoutsIndex();
 
     emit layoutsChanged();
     emit menuLayoutsChanged();
@@ -592,6 +759,8 @@ void Synchronizer::loadLayouts()
 
 void Synchronizer::unloadLayouts()
 {
+    unloadStandbyLayouts();
+
     //! Unload all CentralLayouts
     while (!m_centralLayouts.isEmpty()) {
         CentralLayout *layout = m_centralLayouts.at(0);
@@ -603,20 +772,15 @@ void Synchronizer::unloadLayouts()
 
 void Synchronizer::updateCurrentLayoutNameInMultiEnvironment()
 {
-    for (const auto layout : m_centralLayouts) {
-        if (layout->activities().contains(m_manager->corona()->activitiesConsumer()->currentActivity())) {
-            m_currentLayoutNameInMultiEnvironment = layout->name();
-            emit currentLayoutNameChanged();
-            return;
-        }
+    CentralLayout *layout = m_activitiesIndex.value(m_manager->corona()->activitiesConsumer()->currentActivity(), nullptr);
+
+    if (!layout) {
+        layout = m_orphansCentralLayout;
     }
 
-    for (const auto layout : m_centralLayouts) {
-        if (layout->activities().isEmpty()) {
-            m_currentLayoutNameInMultiEnvironment = layout->name();
-            emit currentLayoutNameChanged();
-            return;
-        }
+    if (layout) {
+        m_currentLayoutNameInMultiEnvironment = layout->name();
+        emit currentLayoutNameChanged();
     }
 }
 
@@ -635,6 +799,8 @@ bool Synchronizer::switchToLayout(QString layoutName, int previousMemoryUsage)
         return false;
     }
 
+    m_switchTime.start();
+
     //! First Check If that Layout is already present and in that case
     //! we can just switch to the proper Activity
     if (m_manager->memoryUsage() == Types::MultipleLayouts && previousMemoryUsage == -1) {
@@ -701,6 +867,7 @@ bool Synchronizer::switchToLayout(QString layoutName, int previousMemoryUsage)
         //! sessions.
         QTimer::singleShot(350, [this, layoutName, lPath, previousMemoryUsage]() {
             qDebug() << layoutName << " - " << lPath;
+            qDebug() << "LAYOUT SWITCH ::: " << layoutName << " started after :: " << m_switchTime.elapsed() << "ms";
             QString fixedLPath = lPath;
             QString fixedLayoutName = layoutName;
 
@@ -713,6 +880,8 @@ bool Synchronizer::switchToLayout(QString layoutName, int previousMemoryUsage)
             if (m_manager->memoryUsage() == Types::SingleLayout || initializingMultipleLayouts || previousMemoryUsage == Types::MultipleLayouts) {
                 unloadLayouts();
 
+                qDebug() << "LAYOUT SWITCH ::: " << layoutName << " unloaded previous layouts at :: " << m_switchTime.elapsed() << "ms";
+
                 if (initializingMultipleLayouts) {
                     fixedLayoutName = QString(Layout::AbstractLayout::MultipleLayoutsName);
                     fixedLPath = layoutPath(fixedLayoutName);
@@ -725,6 +894,8 @@ bool Synchronizer::switchToLayout(QString layoutName, int previousMemoryUsage)
 
                 m_manager->loadLatteLayout(fixedLPath);
 
+                qDebug() << "LAYOUT SWITCH ::: " << layoutName << " loaded at :: " << m_switchTime.elapsed() << "ms";
+
                 if (initializingMultipleLayouts) {
                     m_multipleModeInitialized = true;
                 }
@@ -740,7 +911,6 @@ bool Synchronizer::switchToLayout(QString layoutName, int previousMemoryUsage)
                     //! is such case we just activate these Activities
                     CentralLayout layout(this, Importer::layoutFilePath(layoutName));
 
-                    int i = 0;
                     bool lastUsedActivityFound{false};
                     QString lastUsedActivity = layout.lastUsedActivity();
 
@@ -750,21 +920,12 @@ bool Synchronizer::switchToLayout(QString layoutName, int previousMemoryUsage)
 
                     if (!orphanedLayout) {
                         for (const auto &assignedActivity : assignedActivities) {
-                            //! Starting the activities must be done asynchronous because otherwise
-                            //! the activity manager cant close multiple activities
-                            QTimer::singleShot(i * 1000, [this, assignedActivity, lastUsedActivity]() {
-                                m_activitiesController->startActivity(assignedActivity);
-
-                                if (lastUsedActivity == assignedActivity) {
-                                    m_activitiesController->setCurrentActivity(lastUsedActivity);
-                                }
-                            });
-
                             if (lastUsedActivity == assignedActivity) {
+                                requestActivity(assignedActivity, StartAndSetCurrentActivity);
                                 lastUsedActivityFound = true;
+                            } else {
+                                requestActivity(assignedActivity, StartActivity);
                             }
-
-                            i = i + 1;
                         }
                     } else {
                         //! orphaned layout
@@ -777,12 +938,7 @@ bool Synchronizer::switchToLayout(QString layoutName, int previousMemoryUsage)
                         if ((!lastUsedActivityFound && assignedActivities.count() == 0)
                                 || !assignedActivities.contains(m_manager->corona()->activitiesConsumer()->currentActivity())) {
 
-                            //! Starting the activities must be done asynchronous because otherwise
-                            //! the activity manager cant close multiple activities
-                            QTimer::singleShot(1000, [this, lastUsedActivity, lastUsedActivityFound]() {
-                                m_activitiesController->startActivity(lastUsedActivity);
-                                m_activitiesController->setCurrentActivity(lastUsedActivity);
-                            });
+                            requestActivity(lastUsedActivity, StartAndSetCurrentActivity);
                         }
                     }
 
@@ -801,6 +957,8 @@ bool Synchronizer::switchToLayout(QString layoutName, int previousMemoryUsage)
             if (!layoutIsAssigned(layoutName)) {
                 m_manager->corona()->universalSettings()->setLastNonAssignedLayoutName(layoutName);
             }
+
+            qDebug() << "LAYOUT SWITCH ::: " << layoutName << " finished at :: " << m_switchTime.elapsed() << "ms";
         });
     } else {
         qDebug() << "Layout : " << layoutName << " was not found...";
@@ -809,6 +967,62 @@ bool Synchronizer::switchToLayout(QString layoutName, int previousMemoryUsage)
     return true;
 }
 
+void Synchronizer::requestActivity(const QString &activityId, ActivityRequestType type)
+{
+    if (activityId.isEmpty()) {
+        return;
+    }
+
+    ActivityRequest request;
+    request.activityId = activityId;
+    request.type = type;
+
+    m_activityRequests << request;
+
+    //! requests are always sent asynchronously, they can be triggered also from qml
+    QTimer::singleShot(0, this, &Synchronizer::processActivityRequests);
+}
+
+void Synchronizer::processActivityRequests()
+{
+    if (m_activityRequestRunning || m_activityRequests.isEmpty()) {
+        return;
+    }
+
+    //! the activity manager can not handle multiple activities requests at the same time,
+    //! so each request is sent when the previous one finished or the fallback delay passed
+    ActivityRequest request = m_activityRequests.takeFirst();
+
+    QFuture<void> future = (request.type == StopActivity) ? m_activitiesController->stopActivity(request.activityId)
+                                                          : m_activitiesController->startActivity(request.activityId);
+
+    if (request.type == StartAndSetCurrentActivity) {
+        m_activitiesController->setCurrentActivity(request.activityId);
+    }
+
+    m_activityRequestRunning = true;
+    m_activityRequestTime.start();
+    m_activityRequestTimer.start(m_manager->corona()->universalSettings()->activitiesFallbackDelay());
+    m_activityRequestWatcher.setFuture(future);
+}
+
+void Synchronizer::activityRequestFinished()
+{
+    if (!m_activityRequestRunning) {
+        return;
+    }
+
+    if (m_activityRequestTimer.isActive()) {
+        m_activityRequestTimer.stop();
+        qDebug() << "Activity request finished in :: " << m_activityRequestTime.elapsed() << "ms";
+    } else {
+        qDebug() << "Activity request was not confirmed, moving on after fallback delay :: " << m_activityRequestTime.elapsed() << "ms";
+    }
+
+    m_activityRequestRunning = false;
+    processActivityRequests();
+}
+
 void Synchronizer::syncMultipleLayoutsToActivities(QString layoutForOrphans)
 {
     qDebug() << "   ----  --------- ------    syncMultipleLayoutsToActivities       -------   ";
@@ -819,14 +1033,16 @@ void Synchronizer::syncMultipleLayoutsToActivities(QString layoutForOrphans)
 
     bool allRunningActivitiesWillBeReserved{true};
 
-    if (layoutForOrphans.isEmpty() || m_assignedLayouts.values().contains(layoutForOrphans)) {
+    if (layoutForOrphans.isEmpty() || m_assignedLayoutsIndex.contains(layoutForOrphans)) {
         layoutForOrphans = m_manager->corona()->universalSettings()->lastNonAssignedLayoutName();
     }
 
     for (const auto &activity : runningActivities()) {
-        if (!m_assignedLayouts[activity].isEmpty()) {
-            if (!layoutsToLoad.contains(m_assignedLayouts[activity])) {
-                layoutsToLoad.append(m_assignedLayouts[activity]);
+        QString assignedLayout = m_assignedLayouts.value(activity);
+
+        if (!assignedLayout.isEmpty()) {
+            if (!layoutsToLoad.contains(assignedLayout)) {
+                layoutsToLoad.append(assignedLayout);
             }
         } else {
             allRunningActivitiesWillBeReserved = false;
@@ -854,9 +1070,15 @@ void Synchronizer::syncMultipleLayoutsToActivities(QString layoutForOrphans)
         int posLayout = centralLayoutPos(layoutName);
 
         if (posLayout >= 0) {
-            qDebug() << "REMOVING LAYOUT ::::: " << layoutName;
             m_centralLayouts.removeAt(posLayout);
+            updateLayoutsIndex();
 
+            if (putOnStandby(layout)) {
+                qDebug() << "LAYOUT ON STANDBY ::::: " << layoutName;
+                continue;
+            }
+
+            qDebug() << "REMOVING LAYOUT ::::: " << layoutName;
             layout->syncToLayoutFile(true);
             layout->unloadContainments();
             layout->unloadLatteViews();
@@ -867,7 +1089,7 @@ void Synchronizer::syncMultipleLayoutsToActivities(QString layoutForOrphans)
 
     //! Add Layout for orphan activities
     if (!allRunningActivitiesWillBeReserved) {
-        if (!centralLayout(layoutForOrphans)) {
+        if (!centralLayout(layoutForOrphans) && !resumeFromStandby(layoutForOrphans)) {
             CentralLayout *newLayout = new CentralLayout(this, layoutPath(layoutForOrphans), layoutForOrphans);
 
             if (newLayout) {
@@ -880,7 +1102,7 @@ void Synchronizer::syncMultipleLayoutsToActivities(QString layoutForOrphans)
 
     //! Add needed Layouts based on Activities
     for (const auto &layoutName : layoutsToLoad) {
-        if (!centralLayout(layoutName)) {
+        if (!centralLayout(layoutName) && !resumeFromStandby(layoutName)) {
             CentralLayout *newLayout = new CentralLayout(this, QString(layoutPath(layoutName)), layoutName);
 
             if (newLayout) {
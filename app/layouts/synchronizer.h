@@ -21,8 +21,11 @@
 #define LAYOUTSSYNCHRONIZER_H
 
 // Qt
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 #include <QObject>
 #include <QHash>
+#include <QSet>
 #include <QTimer>
 
 
@@ -34,6 +37,7 @@ namespace Layout{
 class GenericLayout;
 }
 namespace Layouts {
+class Catalogue;
 class Manager;
 }
 }
@@ -75,6 +79,9 @@ public:
 
     void hideAllViews();
     void pauseLayout(QString layoutName);
+    //! layouts on standby are unloaded when their files can be edited directly,
+    //! e.g. from the settings window
+    void unloadStandbyLayouts();
     void syncActiveLayoutsToOriginalFiles();
     void syncLatteViewsToScreens();
     void syncMultipleLayoutsToActivities(QString layoutForOrphans = QString());
@@ -105,6 +112,7 @@ public:
     QStringList orphanedActivities(); //! These are activities that haven't been assigned to specific layout
 
     Latte::View *viewForContainment(Plasma::Containment *containment);
+    QList<Latte::View *> currentViews();
 
     CentralLayout *currentLayout() const;
     CentralLayout *centralLayout(QString id) const;
@@ -119,16 +127,29 @@ signals:
     void runningActicitiesChanged();
 
     void currentLayoutIsSwitching(QString layoutName);
+    void layoutIsResuming(QString layoutName);
 
 private slots:
     void confirmDynamicSwitch();
     void updateDynamicSwitchInterval();
     void updateCurrentLayoutNameInMultiEnvironment();
+    void updateLayoutsIndex();
+    void updateStandbyLayouts();
+
+    void processActivityRequests();
+    void activityRequestFinished();
 
     void currentActivityChanged(const QString &id);
 
 private:
+    enum ActivityRequestType {
+        StartActivity = 0,
+        StartAndSetCurrentActivity,
+        StopActivity
+    };
+
     void clearSharedLayoutsFromCentralLists();
+    void updateAssignedLayoutsIndex();
 
     void addLayout(CentralLayout *layout);
     void unloadCentralLayout(CentralLayout *layout);
@@ -140,6 +161,18 @@ private:
 
     QStringList validActivities(QStringList currentList);
 
+    //! activities are started and stopped one after the other through the activity manager
+    void requestActivity(const QString &activityId, ActivityRequestType type);
+
+    //! MultipleLayouts: central layouts that are not needed are kept loaded with hidden
+    //! views instead of being unloaded, when the standby settings permit it
+    bool putOnStandby(CentralLayout *layout);
+    CentralLayout *resumeFromStandby(const QString &layoutName);
+    void unloadStandbyLayout(CentralLayout *layout);
+
+    //! returns -1 when the resident memory of the process can not be read
+    static qint64 residentMemory();
+
 private:
     bool m_multipleModeInitialized{false};
 
@@ -151,12 +184,42 @@ private:
     QStringList m_sharedLayoutIds;
 
     QHash<const QString, QString> m_assignedLayouts;
+    //! names of the layouts that are assigned to activities
+    QSet<QString> m_assignedLayoutsIndex;
+
+    //! indexes of the loaded layouts, they are updated whenever layouts are loaded,
+    //! unloaded, renamed or their activities change
+    QHash<QString, CentralLayout *> m_centralLayoutsIndex;
+    QHash<QString, SharedLayout *> m_sharedLayoutsIndex;
+    //! activity id -> loaded central layout assigned to it
+    QHash<QString, CentralLayout *> m_activitiesIndex;
+    //! the first loaded central layout without assigned activities
+    CentralLayout *m_orphansCentralLayout{nullptr};
 
     QTimer m_dynamicSwitchTimer;
 
+    //! activities requests waiting for the activity manager
+    struct ActivityRequest {
+        QString activityId;
+        ActivityRequestType type{StartActivity};
+    };
+
+    bool m_activityRequestRunning{false};
+    QList<ActivityRequest> m_activityRequests;
+    QFutureWatcher<void> m_activityRequestWatcher;
+    //! fallback for requests whose completion is never reported
+    QTimer m_activityRequestTimer;
+    QElapsedTimer m_activityRequestTime;
+
+    //! measures the phases of layouts switching
+    QElapsedTimer m_switchTime;
+
     QList<CentralLayout *> m_centralLayouts;
+    //! loaded central layouts on standby, the most recently used is first
+    QList<CentralLayout *> m_standbyLayouts;
     QList<SharedLayout *> m_sharedLayouts;
 
+    Layouts::Catalogue *m_catalogue{nullptr};
     Layouts::Manager *m_manager;
     KActivities::Controller *m_activitiesController;
 };
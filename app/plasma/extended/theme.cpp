@@ -28,9 +28,11 @@
 #include "../../../liblatte2/commontools.h"
 
 // Qt
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QProcess>
+#include <QStandardPaths>
 
 // KDE
 #include <KDirWatch>
@@ -42,6 +44,8 @@
 
 #define DEFAULTCOLORSCHEME "default.colors"
 #define REVERSEDCOLORSCHEME "reversed.colors"
+#define CACHEGROUP "Cache"
+#define CACHEFILE "plasmathemerc"
 
 namespace Latte {
 namespace PlasmaExtended {
@@ -52,6 +56,20 @@ Theme::Theme(KSharedConfig::Ptr config, QObject *parent) :
 {
     m_corona = qobject_cast<Latte::Corona *>(parent);
 
+    m_schemesCachePath = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/lattedock/plasmatheme";
+    QDir().mkpath(m_schemesCachePath);
+
+    //! derived theme metrics are not user settings, they are kept in the cache location
+    QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QDir().mkpath(cachePath);
+    m_cacheGroup = KConfigGroup(KSharedConfig::openConfig(cachePath + "/" + CACHEFILE, KConfig::SimpleConfig), CACHEGROUP);
+
+    //! remove the cache that older versions were storing in user settings
+    if (m_themeGroup.hasGroup(CACHEGROUP)) {
+        m_themeGroup.deleteGroup(CACHEGROUP);
+        m_themeGroup.sync();
+    }
+
     //! compositing tracking
     if (KWindowSystem::isPlatformWayland()) {
         //! TODO: Wayland compositing active
@@ -204,15 +222,19 @@ void Theme::setOriginalSchemeFile(const QString &file)
 //! WM and the plasma theme records
 void Theme::updateDefaultScheme()
 {
-    QString defaultFilePath = m_extendedThemeDir.path() + "/" + DEFAULTCOLORSCHEME;
-    if (QFileInfo(defaultFilePath).exists()) {
-        QFile(defaultFilePath).remove();
-    }
-
-    QFile(m_originalSchemePath).copy(defaultFilePath);
+    QString defaultFilePath = m_schemesCachePath + "/" + DEFAULTCOLORSCHEME;
     m_defaultSchemePath = defaultFilePath;
 
-    updateDefaultSchemeValues();
+    if (!schemeIsCached(defaultFilePath, "defaultSchemeStamp")) {
+        if (QFileInfo(defaultFilePath).exists()) {
+            QFile(defaultFilePath).remove();
+        }
+
+        QFile(m_originalSchemePath).copy(defaultFilePath);
+
+        updateDefaultSchemeValues();
+        setSchemeCached("defaultSchemeStamp");
+    }
 
     if (m_defaultScheme) {
         disconnect(m_defaultScheme, &WindowSystem::SchemeColors::colorsChanged, this, &Theme::loadThemeLightness);
@@ -244,16 +266,19 @@ void Theme::updateDefaultSchemeValues()
 
 void Theme::updateReversedScheme()
 {
-    QString reversedFilePath = m_extendedThemeDir.path() + "/" + REVERSEDCOLORSCHEME;
+    QString reversedFilePath = m_schemesCachePath + "/" + REVERSEDCOLORSCHEME;
+    m_reversedSchemePath = reversedFilePath;
 
-    if (QFileInfo(reversedFilePath).exists()) {
-        QFile(reversedFilePath).remove();
-    }
+    if (!schemeIsCached(reversedFilePath, "reversedSchemeStamp")) {
+        if (QFileInfo(reversedFilePath).exists()) {
+            QFile(reversedFilePath).remove();
+        }
 
-    QFile(m_originalSchemePath).copy(reversedFilePath);
-    m_reversedSchemePath = reversedFilePath;
+        QFile(m_originalSchemePath).copy(reversedFilePath);
 
-    updateReversedSchemeValues();
+        updateReversedSchemeValues();
+        setSchemeCached("reversedSchemeStamp");
+    }
 
     if (m_reversedScheme) {
         m_reversedScheme->deleteLater();
@@ -435,12 +460,135 @@ void Theme::loadCompositingRoundness()
 
 void Theme::loadRoundness()
 {
-    loadCompositingRoundness();
+    if (!loadCachedRoundness()) {
+        loadCompositingRoundness();
+        saveCachedRoundness();
+    }
 
     emit maxOpacityChanged();
     emit roundnessChanged();
 }
 
+QStringList Theme::themeFallbacks() const
+{
+    //! FrameSvg looks up the panel background in the fallback themes of the theme and
+    //! finally in the default theme, fallback themes can declare their own fallbacks
+    QStringList themes{m_theme.themeName()};
+
+    for (int i = 0; i < themes.count(); ++i) {
+        QString metadataFile = Layouts::Importer::standardPath("plasma/desktoptheme/" + themes[i] + "/metadata.desktop");
+
+        if (!QFileInfo(metadataFile).exists()) {
+            continue;
+        }
+
+        KConfig metadata(metadataFile, KConfig::SimpleConfig);
+        QStringList fallbacks = KConfigGroup(&metadata, "Settings").readEntry("FallbackTheme", QStringList());
+
+        for (const auto &fallback : fallbacks) {
+            if (!fallback.isEmpty() && !themes.contains(fallback)) {
+                themes << fallback;
+            }
+        }
+    }
+
+    if (!themes.contains("default")) {
+        themes << "default";
+    }
+
+    return themes;
+}
+
+QString Theme::themeStamp() const
+{
+    //! the panel background svg files that FrameSvg is going to use
+    QStringList files;
+
+    for (const auto &theme : themeFallbacks()) {
+        QString themePath = Layouts::Importer::standardPath("plasma/desktoptheme/" + theme);
+
+        files << themePath + "/metadata.desktop"
+              << themePath + "/widgets/panel-background.svg"
+              << themePath + "/widgets/panel-background.svgz"
+              << themePath + "/opaque/widgets/panel-background.svg"
+              << themePath + "/opaque/widgets/panel-background.svgz";
+    }
+
+    QString stamp = m_theme.themeName() + (m_compositing ? "_compositing" : "_opaque");
+
+    for (const auto &file : files) {
+        QFileInfo info(file);
+
+        if (info.exists()) {
+            stamp += "_" + QString::number(info.lastModified().toMSecsSinceEpoch());
+        }
+    }
+
+    return stamp;
+}
+
+QString Theme::schemeStamp() const
+{
+    QFileInfo info(m_originalSchemePath);
+
+    if (!info.exists()) {
+        return QString();
+    }
+
+    return m_originalSchemePath + "_" + QString::number(info.lastModified().toMSecsSinceEpoch());
+}
+
+bool Theme::loadCachedRoundness()
+{
+    if (m_cacheGroup.readEntry("roundnessStamp", QString()) != themeStamp()) {
+        return false;
+    }
+
+    m_bottomEdgeRoundness = m_cacheGroup.readEntry("bottomEdgeRoundness", 0);
+    m_leftEdgeRoundness = m_cacheGroup.readEntry("leftEdgeRoundness", 0);
+    m_topEdgeRoundness = m_cacheGroup.readEntry("topEdgeRoundness", 0);
+    m_rightEdgeRoundness = m_cacheGroup.readEntry("rightEdgeRoundness", 0);
+
+    m_bottomEdgeMaxOpacity = (float)m_cacheGroup.readEntry("bottomEdgeMaxOpacity", 1.0);
+    m_leftEdgeMaxOpacity = (float)m_cacheGroup.readEntry("leftEdgeMaxOpacity", 1.0);
+    m_topEdgeMaxOpacity = (float)m_cacheGroup.readEntry("topEdgeMaxOpacity", 1.0);
+    m_rightEdgeMaxOpacity = (float)m_cacheGroup.readEntry("rightEdgeMaxOpacity", 1.0);
+
+    qDebug() << " CACHED ROUNDNESS ::: " << m_bottomEdgeRoundness << " _ " << m_leftEdgeRoundness << " _ " << m_topEdgeRoundness << " _ " << m_rightEdgeRoundness;
+
+    return true;
+}
+
+void Theme::saveCachedRoundness()
+{
+    m_cacheGroup.writeEntry("roundnessStamp", themeStamp());
+
+    m_cacheGroup.writeEntry("bottomEdgeRoundness", m_bottomEdgeRoundness);
+    m_cacheGroup.writeEntry("leftEdgeRoundness", m_leftEdgeRoundness);
+    m_cacheGroup.writeEntry("topEdgeRoundness", m_topEdgeRoundness);
+    m_cacheGroup.writeEntry("rightEdgeRoundness", m_rightEdgeRoundness);
+
+    m_cacheGroup.writeEntry("bottomEdgeMaxOpacity", (double)m_bottomEdgeMaxOpacity);
+    m_cacheGroup.writeEntry("leftEdgeMaxOpacity", (double)m_leftEdgeMaxOpacity);
+    m_cacheGroup.writeEntry("topEdgeMaxOpacity", (double)m_topEdgeMaxOpacity);
+    m_cacheGroup.writeEntry("rightEdgeMaxOpacity", (double)m_rightEdgeMaxOpacity);
+
+    m_cacheGroup.sync();
+}
+
+bool Theme::schemeIsCached(const QString &schemeFile, const QString &stampKey)
+{
+    QString stamp = schemeStamp();
+
+    return !stamp.isEmpty() && QFileInfo(schemeFile).exists() && m_cacheGroup.readEntry(stampKey, QString()) == stamp;
+}
+
+void Theme::setSchemeCached(const QString &stampKey)
+{
+    m_cacheGroup.writeEntry(stampKey, schemeStamp());
+    m_cacheGroup.sync();
+}
+
 void Theme::loadThemePaths()
 {
     m_themePath = Layouts::Importer::standardPath("plasma/desktoptheme/" + m_theme.themeName());
@@ -114,6 +114,16 @@ private:
     void loadRoundness();
     void loadCompositingRoundness();
 
+    //! derived theme metrics are cached and they are recalculated only when the theme changes
+    bool loadCachedRoundness();
+    void saveCachedRoundness();
+    bool schemeIsCached(const QString &schemeFile, const QString &stampKey);
+    void setSchemeCached(const QString &stampKey);
+
+    QString schemeStamp() const;
+    QString themeStamp() const;
+    QStringList themeFallbacks() const;
+
     void setOriginalSchemeFile(const QString &file);
     void parseThemeSvgFiles();
     void updateDefaultScheme();
@@ -144,11 +154,13 @@ private:
     QString m_defaultSchemePath;
     QString m_originalSchemePath;
     QString m_reversedSchemePath;
+    QString m_schemesCachePath;
 
     std::array<QMetaObject::Connection, 2> m_kdeConnections;
 
     QTemporaryDir m_extendedThemeDir;
     KConfigGroup m_themeGroup;
+    KConfigGroup m_cacheGroup;
     Plasma::Theme m_theme;
 
     Latte::Corona *m_corona{nullptr};
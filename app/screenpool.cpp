@@ -48,6 +48,15 @@ ScreenPool::ScreenPool(KSharedConfig::Ptr config, QObject *parent)
     connect(&m_configSaveTimer, &QTimer::timeout, this, [this]() {
         m_configGroup.sync();
     });
+
+    connect(qGuiApp, &QGuiApplication::screenAdded, this, &ScreenPool::updateScreensTable);
+    connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, &ScreenPool::updateScreensTable);
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, [this](QScreen *screen) {
+        //! the removed screen is still part of qGuiApp->screens() at that point
+        if (m_idForScreen.contains(screen)) {
+            m_screenForId.remove(m_idForScreen.take(screen));
+        }
+    });
 }
 
 void ScreenPool::load()
@@ -93,6 +102,8 @@ void ScreenPool::load()
             insertScreenMapping(firstAvailableId(), screen->name());
         }
     }
+
+    updateScreensTable();
 }
 
 ScreenPool::~ScreenPool()
@@ -182,9 +193,25 @@ void ScreenPool::insertScreenMapping(int id, const QString &connector)
         m_idForConnector[connector] = id;
     }
 
+    updateScreensTable();
     save();
 }
 
+void ScreenPool::updateScreensTable()
+{
+    m_screenForId.clear();
+    m_idForScreen.clear();
+
+    for (const auto scr : qGuiApp->screens()) {
+        const int scrId = id(scr->name());
+
+        if (scrId >= 0) {
+            m_screenForId[scrId] = scr;
+            m_idForScreen[scr] = scrId;
+        }
+    }
+}
+
 int ScreenPool::id(const QString &connector) const
 {
     if (!m_idForConnector.contains(connector)) {
@@ -194,6 +221,11 @@ int ScreenPool::id(const QString &connector) const
     return m_idForConnector.value(connector);
 }
 
+int ScreenPool::id(const QScreen *screen) const
+{
+    return m_idForScreen.value(screen, -1);
+}
+
 QString ScreenPool::connector(int id) const
 {   
     Q_ASSERT(m_connectorForId.contains(id));
@@ -233,35 +265,14 @@ bool ScreenPool::hasId(int id)
 
 bool ScreenPool::screenExists(int id)
 {
-    if (id != -1 && knownIds().contains(id)) {
-        QString scrName = connector(id);
-
-        for (const auto scr : qGuiApp->screens()) {
-            if (scr->name() == scrName) {
-                return true;
-            }
-        }
-    }
-
-    return false;
+    return (id != -1 && m_screenForId.value(id));
 }
 
 QScreen *ScreenPool::screenForId(int id)
 {
-    const auto screens = qGuiApp->screens();
-    QScreen *screen{qGuiApp->primaryScreen()};
+    QScreen *screen = m_screenForId.value(id);
 
-    if (id != -1 && knownIds().contains(id)) {
-        QString scrName = connector(id);
-
-        for (const auto scr : screens) {
-            if (scr->name() == scrName) {
-                return scr;
-            }
-        }
-    }
-
-    return screen;
+    return screen ? screen : qGuiApp->primaryScreen();
 }
 
 
@@ -285,6 +296,9 @@ bool ScreenPool::nativeEventFilter(const QByteArray &eventType, void *message, l
     const xcb_query_extension_reply_t *reply = xcb_get_extension_data(QX11Info::connection(), &xcb_randr_id);
 
     if (responseType == reply->first_event + XCB_RANDR_SCREEN_CHANGE_NOTIFY) {
+        //! the same QScreen can be recycled for a different connector
+        updateScreensTable();
+
         if (qGuiApp->primaryScreen()->name() != primaryConnector()) {
             //new screen?
             if (id(qGuiApp->primaryScreen()->name()) < 0) {
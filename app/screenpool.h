@@ -23,6 +23,7 @@
 // Qt
 #include <QObject>
 #include <QHash>
+#include <QPointer>
 #include <QScreen>
 #include <QString>
 #include <QTimer>
@@ -54,6 +55,8 @@ public:
     void reload(QString path);
 
     int id(const QString &connector) const;
+    //! -1 when the screen is not known
+    int id(const QScreen *screen) const;
 
     QString connector(int id) const;
 
@@ -70,6 +73,11 @@ signals:
 protected:
     bool nativeEventFilter(const QByteArray &eventType, void *message, long *result) Q_DECL_OVERRIDE;
 
+private slots:
+    //! id <-> QScreen tables are updated whenever screens or their connectors change,
+    //! in order for screen queries to not compare connector names
+    void updateScreensTable();
+
 private:
     void save();
 
@@ -79,6 +87,9 @@ private:
     QMap<int, QString> m_connectorForId;
     QHash<QString, int> m_idForConnector;
 
+    QHash<int, QPointer<QScreen>> m_screenForId;
+    QHash<const QScreen *, int> m_idForScreen;
+
     QTimer m_configSaveTimer;
 };
 
@@ -40,6 +40,7 @@
 #include "delegates/shareddelegate.h"
 
 // Qt
+#include <QApplication>
 #include <QButtonGroup>
 #include <QColorDialog>
 #include <QDesktopServices>
@@ -49,6 +50,7 @@
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QProcess>
+#include <QProgressDialog>
 #include <QStandardItem>
 #include <QStandardItemModel>
 #include <QTemporaryDir>
@@ -656,12 +658,8 @@ void SettingsDialog::on_exportButton_clicked()
 
     QString layoutExported = m_model->data(m_model->index(row, IDCOLUMN), Qt::DisplayRole).toString();
 
-    //! Update ALL active original layouts before exporting,
-    //! this is needed because the export method can export also the full configuration
     qDebug() << Q_FUNC_INFO;
 
-    m_corona->layoutsManager()->synchronizer()->syncActiveLayoutsToOriginalFiles();
-
     QFileDialog *fileDialog = new QFileDialog(this, i18nc("export layout/configuration", "Export Layout/Configuration")
                                               , QDir::homePath(), QStringLiteral("layout.latte"));
 
@@ -689,12 +687,16 @@ void SettingsDialog::on_exportButton_clicked()
             notification->sendEvent();
         };
 
-        if (QFile::exists(file) && !QFile::remove(file)) {
-            showNotificationError();
-            return;
-        }
-
         if (file.endsWith(".layout.latte")) {
+            //! Update ALL active original layouts before exporting, the full configuration
+            //! export is doing the same by itself and replaces the file only when it succeeds
+            m_corona->layoutsManager()->synchronizer()->syncActiveLayoutsToOriginalFiles();
+
+            if (QFile::exists(file) && !QFile::remove(file)) {
+                showNotificationError();
+                return;
+            }
+
             if (!QFile(layoutExported).copy(file)) {
                 showNotificationError();
                 return;
@@ -728,7 +730,23 @@ void SettingsDialog::on_exportButton_clicked()
                 notification->sendEvent();
             };
 
-            if (m_corona->layoutsManager()->importer()->exportFullConfiguration(file)) {
+            auto importer = m_corona->layoutsManager()->importer();
+
+            //! the dialog is shown only when the export takes long enough, the connection
+            //! is dropped together with the dialog
+            QProgressDialog progressDialog(i18nc("import/export config", "Exporting full configuration..."), QString(), 0, 0, this);
+            progressDialog.setWindowModality(Qt::WindowModal);
+
+            connect(importer, &Latte::Layouts::Importer::exportProgressChanged, &progressDialog, [&progressDialog](int done, int total) {
+                progressDialog.setMaximum(total);
+                progressDialog.setValue(done);
+            });
+
+            QApplication::setOverrideCursor(Qt::BusyCursor);
+            bool exported = importer->exportFullConfiguration(file);
+            QApplication::restoreOverrideCursor();
+
+            if (exported) {
 
                 auto notification = new KNotification("export-done", KNotification::CloseOnTimeout);
                 notification->setActions({i18nc("import/export config", "Open location")});
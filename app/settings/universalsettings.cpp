@@ -39,6 +39,10 @@
 
 #define KWINCOLORSSCRIPT "kwin/scripts/lattewindowcolors"
 
+#define SCREENTRACKERDEBOUNCE 150
+//! corona re-syncs views to screens only after the views have synced their own screens
+#define SCREENTRACKERSYNCOFFSET 150
+
 namespace Latte {
 
 UniversalSettings::UniversalSettings(KSharedConfig::Ptr config, QObject *parent)
@@ -48,6 +52,7 @@ UniversalSettings::UniversalSettings(KSharedConfig::Ptr config, QObject *parent)
 {
     m_corona = qobject_cast<Latte::Corona *>(parent);
 
+    connect(this, &UniversalSettings::activitiesFallbackDelayChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::canDisableBordersChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::currentLayoutNameChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::downloadWindowSizeChanged, this, &UniversalSettings::saveConfig);
@@ -59,7 +64,11 @@ UniversalSettings::UniversalSettings(KSharedConfig::Ptr config, QObject *parent)
     connect(this, &UniversalSettings::metaPressAndHoldEnabledChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::mouseSensitivityChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::screenTrackerIntervalChanged, this, &UniversalSettings::saveConfig);
+    connect(this, &UniversalSettings::screenTrackerPollingChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::showInfoWindowChanged, this, &UniversalSettings::saveConfig);
+    connect(this, &UniversalSettings::standbyLayoutsChanged, this, &UniversalSettings::saveConfig);
+    connect(this, &UniversalSettings::standbyLayoutsMemoryChanged, this, &UniversalSettings::saveConfig);
+    connect(this, &UniversalSettings::tightViewWindowsChanged, this, &UniversalSettings::saveConfig);
     connect(this, &UniversalSettings::versionChanged, this, &UniversalSettings::saveConfig);
 
     connect(this, &UniversalSettings::screenScalesChanged, this, &UniversalSettings::saveScalesConfig);
@@ -150,6 +159,91 @@ void UniversalSettings::setScreenTrackerInterval(int duration)
     emit screenTrackerIntervalChanged();
 }
 
+bool UniversalSettings::screenTrackerPolling() const
+{
+    return m_screenTrackerPolling;
+}
+
+void UniversalSettings::setScreenTrackerPolling(bool enabled)
+{
+    if (m_screenTrackerPolling == enabled) {
+        return;
+    }
+
+    m_screenTrackerPolling = enabled;
+    emit screenTrackerPollingChanged();
+}
+
+int UniversalSettings::screenTrackerDelay() const
+{
+    return m_screenTrackerPolling ? m_screenTrackerInterval : SCREENTRACKERDEBOUNCE + SCREENTRACKERSYNCOFFSET;
+}
+
+int UniversalSettings::viewsScreenTrackerDelay() const
+{
+    return m_screenTrackerPolling ? qMax(m_screenTrackerInterval - 500, m_screenTrackerInterval / 2) : SCREENTRACKERDEBOUNCE;
+}
+
+int UniversalSettings::activitiesFallbackDelay() const
+{
+    return m_activitiesFallbackDelay;
+}
+
+void UniversalSettings::setActivitiesFallbackDelay(int delay)
+{
+    if (m_activitiesFallbackDelay == delay) {
+        return;
+    }
+
+    m_activitiesFallbackDelay = delay;
+    emit activitiesFallbackDelayChanged();
+}
+
+int UniversalSettings::standbyLayouts() const
+{
+    return m_standbyLayouts;
+}
+
+void UniversalSettings::setStandbyLayouts(int count)
+{
+    if (m_standbyLayouts == count) {
+        return;
+    }
+
+    m_standbyLayouts = count;
+    emit standbyLayoutsChanged();
+}
+
+int UniversalSettings::standbyLayoutsMemory() const
+{
+    return m_standbyLayoutsMemory;
+}
+
+void UniversalSettings::setStandbyLayoutsMemory(int memory)
+{
+    if (m_standbyLayoutsMemory == memory) {
+        return;
+    }
+
+    m_standbyLayoutsMemory = memory;
+    emit standbyLayoutsMemoryChanged();
+}
+
+bool UniversalSettings::tightViewWindows() const
+{
+    return m_tightViewWindows;
+}
+
+void UniversalSettings::setTightViewWindows(bool enabled)
+{
+    if (m_tightViewWindows == enabled) {
+        return;
+    }
+
+    m_tightViewWindows = enabled;
+    emit tightViewWindowsChanged();
+}
+
 QString UniversalSettings::currentLayoutName() const
 {
     return m_currentLayoutName;
@@ -464,6 +558,7 @@ void UniversalSettings::setScreenScales(QString screenName, float widthScale, fl
 void UniversalSettings::loadConfig()
 {
     m_version = m_universalGroup.readEntry("version", 1);
+    m_activitiesFallbackDelay = m_universalGroup.readEntry("activitiesFallbackDelay", 1000);
     m_canDisableBorders = m_universalGroup.readEntry("canDisableBorders", false);
     m_currentLayoutName = m_universalGroup.readEntry("currentLayout", QString());
     m_downloadWindowSize = m_universalGroup.readEntry("downloadWindowSize", QSize(800, 550));
@@ -473,7 +568,11 @@ void UniversalSettings::loadConfig()
     m_launchers = m_universalGroup.readEntry("launchers", QStringList());
     m_metaPressAndHoldEnabled = m_universalGroup.readEntry("metaPressAndHoldEnabled", true);
     m_screenTrackerInterval = m_universalGroup.readEntry("screenTrackerInterval", 2500);
+    m_screenTrackerPolling = m_universalGroup.readEntry("screenTrackerPolling", false);
     m_showInfoWindow = m_universalGroup.readEntry("showInfoWindow", true);
+    m_standbyLayouts = m_universalGroup.readEntry("standbyLayouts", 0);
+    m_standbyLayoutsMemory = m_universalGroup.readEntry("standbyLayoutsMemory", 1024);
+    m_tightViewWindows = m_universalGroup.readEntry("tightViewWindows", false);
     m_memoryUsage = static_cast<Types::LayoutsMemoryUsage>(m_universalGroup.readEntry("memoryUsage", (int)Types::SingleLayout));
     m_mouseSensitivity = static_cast<Types::MouseSensitivity>(m_universalGroup.readEntry("mouseSensitivity", (int)Types::HighSensitivity));
 
@@ -483,6 +582,7 @@ void UniversalSettings::loadConfig()
 void UniversalSettings::saveConfig()
 {
     m_universalGroup.writeEntry("version", m_version);
+    m_universalGroup.writeEntry("activitiesFallbackDelay", m_activitiesFallbackDelay);
     m_universalGroup.writeEntry("canDisableBorders", m_canDisableBorders);
     m_universalGroup.writeEntry("currentLayout", m_currentLayoutName);
     m_universalGroup.writeEntry("downloadWindowSize", m_downloadWindowSize);
@@ -492,7 +592,11 @@ void UniversalSettings::saveConfig()
     m_universalGroup.writeEntry("launchers", m_launchers);
     m_universalGroup.writeEntry("metaPressAndHoldEnabled", m_metaPressAndHoldEnabled);
     m_universalGroup.writeEntry("screenTrackerInterval", m_screenTrackerInterval);
+    m_universalGroup.writeEntry("screenTrackerPolling", m_screenTrackerPolling);
     m_universalGroup.writeEntry("showInfoWindow", m_showInfoWindow);
+    m_universalGroup.writeEntry("standbyLayouts", m_standbyLayouts);
+    m_universalGroup.writeEntry("standbyLayoutsMemory", m_standbyLayoutsMemory);
+    m_universalGroup.writeEntry("tightViewWindows", m_tightViewWindows);
     m_universalGroup.writeEntry("memoryUsage", (int)m_memoryUsage);
     m_universalGroup.writeEntry("mouseSensitivity", (int)m_mouseSensitivity);
 
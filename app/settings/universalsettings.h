@@ -94,6 +94,34 @@ public:
     int screenTrackerInterval() const;
     void setScreenTrackerInterval(int duration);
 
+    //! screens are tracked through screen events with a short debounce, the tracker interval
+    //! is used only when polling is enabled for drivers that report screen changes late
+    bool screenTrackerPolling() const;
+    void setScreenTrackerPolling(bool enabled);
+
+    //! views sync their screens first and corona re-syncs all views afterwards,
+    //! so the views delay is always shorter than the corona one
+    int screenTrackerDelay() const;
+    int viewsScreenTrackerDelay() const;
+
+    //! activities requests are sent one after the other when the previous one finished,
+    //! this delay is used only when the activity manager does not report a request as finished
+    int activitiesFallbackDelay() const;
+    void setActivitiesFallbackDelay(int delay);
+
+    //! MultipleLayouts: the count of unloaded layouts that are kept loaded with hidden
+    //! views in order to switch back to them instantly, zero disables it. They are kept
+    //! only while Latte resident memory is below the standby memory budget, in MB
+    int standbyLayouts() const;
+    void setStandbyLayouts(int count);
+
+    int standbyLayoutsMemory() const;
+    void setStandbyLayoutsMemory(int memory);
+
+    //! docks windows are fitted to their contents instead of the full screen length
+    bool tightViewWindows() const;
+    void setTightViewWindows(bool enabled);
+
     QString currentLayoutName() const;
     void setCurrentLayoutName(QString layoutName);
 
@@ -128,6 +156,7 @@ public slots:
     Q_INVOKABLE void setScreenScales(QString screenName, float widthScale, float heightScale);
 
 signals:
+    void activitiesFallbackDelayChanged();
     void autostartChanged();
     void canDisableBordersChanged();
     void colorsScriptIsPresentChanged();
@@ -143,7 +172,11 @@ signals:
     void screensCountChanged();
     void screenScalesChanged();
     void screenTrackerIntervalChanged();
+    void screenTrackerPollingChanged();
     void showInfoWindowChanged();
+    void standbyLayoutsChanged();
+    void standbyLayoutsMemoryChanged();
+    void tightViewWindowsChanged();
     void versionChanged();
 
 private slots:
@@ -170,12 +203,17 @@ private:
     bool m_canDisableBorders{false};
     bool m_colorsScriptIsPresent{false};
     bool m_metaPressAndHoldEnabled{true};
+    bool m_screenTrackerPolling{false};
     bool m_showInfoWindow{true};
+    bool m_tightViewWindows{false};
 
     //when there isnt a version it is an old universal file
     int m_version{1};
 
+    int m_activitiesFallbackDelay{1000};
     int m_screenTrackerInterval{2500};
+    int m_standbyLayouts{0};
+    int m_standbyLayoutsMemory{1024};
 
     QString m_currentLayoutName;
     QString m_lastNonAssignedLayoutName;
@@ -22,16 +22,23 @@
 // local
 #include "panelshadows_p.h"
 #include "view.h"
+#include "windowtransaction.h"
 #include "settings/primaryconfigview.h"
+#include "../lattecorona.h"
+#include "../plasma/extended/theme.h"
 #include "../../liblatte2/types.h"
 
 // Qt
 #include <QRegion>
+#include <QtMath>
+#include <QVector>
 
 // KDE
 #include <KWindowEffects>
 #include <KWindowSystem>
 
+#define FRAMEMASKSCACHESIZE 64
+
 namespace Latte {
 namespace ViewPart {
 
@@ -53,6 +60,10 @@ void Effects::init()
     connect(this, &Effects::rectChanged, this, &Effects::updateEffects);
     connect(this, &Effects::settingsMaskSubtractedChanged, this, &Effects::updateMask);
 
+    m_updateMaskTimer.setSingleShot(true);
+    m_updateMaskTimer.setInterval(0);
+    connect(&m_updateMaskTimer, &QTimer::timeout, this, &Effects::updateMask);
+
     connect(this, &Effects::drawShadowsChanged, this, [&]() {
         if (m_view->behaveAsPlasmaPanel()) {
             updateEnabledBorders();
@@ -65,20 +76,22 @@ void Effects::init()
     connect(m_view, &Latte::View::configWindowGeometryChanged, this, &Effects::updateMask);
 
     connect(&m_theme, &Plasma::Theme::themeChanged, this, [&]() {
-        auto background = m_background;
-        m_background = new Plasma::FrameSvg(this);
-
-        if (background) {
-            background->deleteLater();
-        }
-
-        if (m_background->imagePath() != "widgets/panel-background") {
-            m_background->setImagePath(QStringLiteral("widgets/panel-background"));
-        }
+        m_frameMasks.clear();
 
         updateBackgroundContrastValues();
         updateEffects();
     });
+
+    auto *latteCorona = qobject_cast<Latte::Corona *>(m_view->corona());
+
+    if (latteCorona) {
+        connect(latteCorona->themeExtended(), &PlasmaExtended::Theme::roundnessChanged, this, [&]() {
+            m_frameMasks.clear();
+
+            updateMask();
+            updateEffects();
+        });
+    }
 }
 
 bool Effects::animationsBlocked() const
@@ -109,11 +122,7 @@ void Effects::setDrawShadows(bool draw)
 
     m_drawShadows = draw;
 
-    if (m_view->behaveAsPlasmaPanel() && m_drawShadows) {
-        PanelShadows::self()->addWindow(m_view, m_enabledBorders);
-    } else {
-        PanelShadows::self()->removeWindow(m_view);
-    }
+    updateShadows();
 
     emit drawShadowsChanged();
 }
@@ -272,18 +281,40 @@ QRegion Effects::subtrackedMaskFromWindow(QRegion initialRegion, QQuickView *win
 
 QRegion Effects::subtractedMask()
 {
-    QRegion subMask = m_mask;
+    if (!m_settingsMaskSubtracted || !m_view->configView()) {
+        return QRegion(m_mask);
+    }
+
+    ViewPart::PrimaryConfigView *primaryConfig = qobject_cast<ViewPart::PrimaryConfigView *>(m_view->configView());
+    QQuickView *secondaryWindow{nullptr};
 
-    if (m_settingsMaskSubtracted && m_view->configView()) {
-        subMask = subtrackedMaskFromWindow(subMask, m_view->configView());
+    if (primaryConfig && m_view->formFactor() == Plasma::Types::Horizontal) {
+        secondaryWindow = primaryConfig->secondaryWindow();
+    }
 
-        ViewPart::PrimaryConfigView *primaryConfig = qobject_cast<ViewPart::PrimaryConfigView *>(m_view->configView());
+    //! the subtracted regions are recalculated only when any of their sources changed
+    SubtractedMaskSources sources;
+    sources.valid = true;
+    sources.mask = m_mask;
+    sources.configGeometry = m_view->configView()->geometry();
+    sources.secondaryGeometry = secondaryWindow ? secondaryWindow->geometry() : QRect();
+    sources.viewPosition = m_view->position();
+    sources.editShadow = m_editShadow;
+    sources.location = m_view->location();
+
+    if (sources == m_subtractedMaskSources) {
+        return m_subtractedMask;
+    }
 
-        if (primaryConfig && m_view->formFactor() == Plasma::Types::Horizontal && primaryConfig->secondaryWindow()) {
-            subMask = subtrackedMaskFromWindow(subMask, primaryConfig->secondaryWindow());
-        }
+    QRegion subMask = subtrackedMaskFromWindow(QRegion(m_mask), m_view->configView());
+
+    if (secondaryWindow) {
+        subMask = subtrackedMaskFromWindow(subMask, secondaryWindow);
     }
 
+    m_subtractedMaskSources = sources;
+    m_subtractedMask = subMask;
+
     return subMask;
 }
 
@@ -295,7 +326,7 @@ QRect Effects::rect() const
 void Effects::setRect(QRect area)
 {
     if (KWindowSystem::compositingActive()) {
-        QRect inWindowRect = area.intersected(QRect(0, 0, m_view->width(), m_view->height()));
+        QRect inWindowRect = area.intersected(QRect(QPoint(0, 0), m_view->fullGeometry().size()));
 
         if (m_rect == inWindowRect) {
             return;
@@ -324,7 +355,9 @@ void Effects::setMask(QRect area)
         return;
 
     m_mask = area;
-    updateMask();
+
+    //! masks are changing on every frame during animations
+    m_updateMaskTimer.start();
 
     // qDebug() << "dock mask set:" << m_mask;
     emit maskChanged();
@@ -332,69 +365,151 @@ void Effects::setMask(QRect area)
 
 void Effects::forceMaskRedraw()
 {
-    if (m_background) {
-        delete m_background;
+    m_frameMasks.clear();
+    m_appliedMask = QRegion();
+
+    updateMask();
+}
+
+int Effects::edgeRoundness() const
+{
+    auto *latteCorona = qobject_cast<Latte::Corona *>(m_view->corona());
+
+    if (!latteCorona) {
+        return 0;
     }
 
-    m_background = new Plasma::FrameSvg(this);
-    m_background->setImagePath(QStringLiteral("widgets/panel-background"));
-    m_background->setEnabledBorders(m_enabledBorders);
+    switch (m_view->location()) {
+    case Plasma::Types::TopEdge:
+        return latteCorona->themeExtended()->topEdgeRoundness();
+    case Plasma::Types::LeftEdge:
+        return latteCorona->themeExtended()->leftEdgeRoundness();
+    case Plasma::Types::RightEdge:
+        return latteCorona->themeExtended()->rightEdgeRoundness();
+    default:
+        return latteCorona->themeExtended()->bottomEdgeRoundness();
+    }
+}
 
-    updateMask();
+//! the region of the panel background for the provided size, it is calculated
+//! from the theme roundness instead of rasterizing the background svg
+QRegion Effects::frameMask(const QSize &size)
+{
+    const int radius = edgeRoundness();
+    const QString key = QString::number(size.width()) + "x" + QString::number(size.height())
+            + "_" + QString::number(static_cast<int>(m_enabledBorders)) + "_" + QString::number(radius);
+
+    if (m_frameMasks.contains(key)) {
+        return m_frameMasks[key];
+    }
+
+    if (m_frameMasks.count() >= FRAMEMASKSCACHESIZE) {
+        m_frameMasks.clear();
+    }
+
+    QRegion mask = roundedMask(size, radius);
+    m_frameMasks[key] = mask;
+
+    return mask;
+}
+
+QRegion Effects::roundedMask(const QSize &size, int radius) const
+{
+    const int width = size.width();
+    const int height = size.height();
+
+    radius = qMin(radius, qMin(width, height) / 2);
+
+    if (radius <= 0) {
+        return QRegion(0, 0, width, height);
+    }
+
+    const bool top = m_enabledBorders.testFlag(Plasma::FrameSvg::TopBorder);
+    const bool bottom = m_enabledBorders.testFlag(Plasma::FrameSvg::BottomBorder);
+    const bool left = m_enabledBorders.testFlag(Plasma::FrameSvg::LeftBorder);
+    const bool right = m_enabledBorders.testFlag(Plasma::FrameSvg::RightBorder);
+
+    //! corners are rounded only when both of their borders are enabled
+    QVector<int> insets(radius);
+
+    for (int i = 0; i < radius; ++i) {
+        const qreal dy = radius - i - 0.5;
+        insets[i] = radius - qRound(qSqrt(radius * radius - dy * dy));
+    }
+
+    //! rectangles must be sorted from top to bottom
+    QVector<QRect> rects;
+    const int topRows = top ? radius : 0;
+    const int bottomRows = bottom ? radius : 0;
+
+    for (int i = 0; i < topRows; ++i) {
+        const int leftInset = left ? insets[i] : 0;
+        const int rightInset = right ? insets[i] : 0;
+        rects << QRect(leftInset, i, width - leftInset - rightInset, 1);
+    }
+
+    rects << QRect(0, topRows, width, height - topRows - bottomRows);
+
+    for (int i = bottomRows - 1; i >= 0; --i) {
+        const int leftInset = left ? insets[i] : 0;
+        const int rightInset = right ? insets[i] : 0;
+        rects << QRect(leftInset, height - 1 - i, width - leftInset - rightInset, 1);
+    }
+
+    QRegion mask;
+    mask.setRects(rects.constData(), rects.count());
+
+    return mask;
 }
 
 void Effects::updateMask()
 {
+    m_updateMaskTimer.stop();
+
+    QRegion windowMask;
+
     if (KWindowSystem::compositingActive()) {
-        if (m_view->behaveAsPlasmaPanel()) {
-            m_view->setMask(QRect());
-        } else {
-            m_view->setMask(subtractedMask());
+        if (!m_view->behaveAsPlasmaPanel()) {
+            windowMask = subtractedMask().translated(m_view->contentOffset());
         }
     } else {
         //! this is used when compositing is disabled and provides
         //! the correct way for the mask to be painted in order for
         //! rounded corners to be shown correctly
-        //! the enabledBorders check was added because there was cases
-        //! that the mask region wasn't calculated correctly after location changes
-        if (!m_background) {
-            if (m_background && m_background->enabledBorders() != m_enabledBorders) {
-                delete m_background;
-            }
-
-            m_background = new Plasma::FrameSvg(this);
-        }
+        windowMask = frameMask(m_mask.size());
+        windowMask.translate(m_mask.x() + m_view->contentOffset().x(), m_mask.y() + m_view->contentOffset().y());
+    }
 
-        if (m_background->imagePath() != "widgets/panel-background") {
-            m_background->setImagePath(QStringLiteral("widgets/panel-background"));
-        }
+    if (windowMask == m_appliedMask) {
+        return;
+    }
 
-        m_background->setEnabledBorders(m_enabledBorders);
-        m_background->resizeFrame(m_mask.size());
-        QRegion fixedMask = m_background->mask();
-        fixedMask.translate(m_mask.x(), m_mask.y());
+    m_appliedMask = windowMask;
 
-        //! fix for KF5.32 that return empty QRegion's for the mask
-        if (fixedMask.isEmpty()) {
-            fixedMask = QRegion(m_mask);
-        }
-
-        m_view->setMask(fixedMask);
-    }
+    m_view->windowTransaction()->schedule(WindowTransaction::Mask, [this, windowMask]() {
+        m_view->setMask(windowMask);
+    });
 }
 
 void Effects::clearShadows()
 {
-    PanelShadows::self()->removeWindow(m_view);
+    m_view->windowTransaction()->schedule(WindowTransaction::Shadows, [this]() {
+        PanelShadows::self()->removeWindow(m_view);
+    });
 }
 
 void Effects::updateShadows()
 {
-    if (m_view->behaveAsPlasmaPanel() && drawShadows()) {
-        PanelShadows::self()->addWindow(m_view, enabledBorders());
-    } else {
-        PanelShadows::self()->removeWindow(m_view);
+    if (!m_view->behaveAsPlasmaPanel() || !m_drawShadows) {
+        clearShadows();
+        return;
     }
+
+    const Plasma::FrameSvg::EnabledBorders borders = m_enabledBorders;
+
+    m_view->windowTransaction()->schedule(WindowTransaction::Shadows, [this, borders]() {
+        PanelShadows::self()->addWindow(m_view, borders);
+    });
 }
 
 void Effects::updateEffects()
@@ -406,37 +521,25 @@ void Effects::updateEffects()
     }
 
     if (m_drawEffects && !m_rect.isNull() && !m_rect.isEmpty()) {
-        //! this is used when compositing is disabled and provides
-        //! the correct way for the mask to be painted in order for
-        //! rounded corners to be shown correctly
-        if (!m_background) {
-            m_background = new Plasma::FrameSvg(this);
-        }
-
-        if (m_background->imagePath() != "widgets/panel-background") {
-            m_background->setImagePath(QStringLiteral("widgets/panel-background"));
-        }
-
-        m_background->setEnabledBorders(m_enabledBorders);
-        m_background->resizeFrame(m_rect.size());
-        QRegion fixedMask = m_background->mask();
-        fixedMask.translate(m_rect.x(), m_rect.y());
-
-        //! fix1, for KF5.32 that return empty QRegion's for the mask
-        if (fixedMask.isEmpty()) {
-            fixedMask = QRegion(m_rect);
-        }
-
-        KWindowEffects::enableBlurBehind(m_view->winId(), true, fixedMask);
-        KWindowEffects::enableBackgroundContrast(m_view->winId(),
-                                                 m_theme.backgroundContrastEnabled(),
-                                                 m_backEffectContrast,
-                                                 m_backEffectIntesity,
-                                                 m_backEffectSaturation,
-                                                 fixedMask);
+        //! the blur region follows the rounded corners of the background
+        QRegion fixedMask = frameMask(m_rect.size());
+        fixedMask.translate(m_rect.x() + m_view->contentOffset().x(), m_rect.y() + m_view->contentOffset().y());
+
+        const bool contrastEnabled = m_theme.backgroundContrastEnabled();
+        const qreal contrast = m_backEffectContrast;
+        const qreal intensity = m_backEffectIntesity;
+        const qreal saturation = m_backEffectSaturation;
+
+        m_view->windowTransaction()->schedule(WindowTransaction::BackgroundEffects,
+                                              [this, fixedMask, contrastEnabled, contrast, intensity, saturation]() {
+            KWindowEffects::enableBlurBehind(m_view->winId(), true, fixedMask);
+            KWindowEffects::enableBackgroundContrast(m_view->winId(), contrastEnabled, contrast, intensity, saturation, fixedMask);
+        });
     } else {
-        KWindowEffects::enableBlurBehind(m_view->winId(), false);
-        KWindowEffects::enableBackgroundContrast(m_view->winId(), false);
+        m_view->windowTransaction()->schedule(WindowTransaction::BackgroundEffects, [this]() {
+            KWindowEffects::enableBlurBehind(m_view->winId(), false);
+            KWindowEffects::enableBackgroundContrast(m_view->winId(), false);
+        });
     }
 }
 
@@ -546,9 +649,11 @@ void Effects::updateEnabledBorders()
     }
 
     if (!m_view->behaveAsPlasmaPanel() || !m_drawShadows) {
-        PanelShadows::self()->removeWindow(m_view);
+        clearShadows();
     } else {
-        PanelShadows::self()->setEnabledBorders(m_view, borders);
+        m_view->windowTransaction()->schedule(WindowTransaction::Shadows, [this, borders]() {
+            PanelShadows::self()->setEnabledBorders(m_view, borders);
+        });
     }
 }
 //!END draw panel shadows outside the dock window
@@ -21,8 +21,11 @@
 #define EFFECTS_H
 
 // Qt
+#include <QHash>
 #include <QObject>
 #include <QPointer>
+#include <QRegion>
+#include <QTimer>
 #include <QQuickView>
 #include <QRect>
 
@@ -120,6 +123,10 @@ private slots:
 private:
     qreal currentMidValue(const qreal &max, const qreal &factor, const qreal &min) const;
 
+    int edgeRoundness() const;
+
+    QRegion frameMask(const QSize &size);
+    QRegion roundedMask(const QSize &size, int radius) const;
     QRegion subtractedMask();
     QRegion subtrackedMaskFromWindow(QRegion initialRegion, QQuickView *window);
 
@@ -141,11 +148,43 @@ private:
     QRect m_rect;
     QRect m_mask;
 
+    //! last region that was applied to the window
+    QRegion m_appliedMask;
+
+    //! the geometries and settings that subtractedMask() is calculated from
+    struct SubtractedMaskSources {
+        bool valid{false};
+        QRect mask;
+        QRect configGeometry;
+        QRect secondaryGeometry;
+        QPoint viewPosition;
+        int editShadow{0};
+        Plasma::Types::Location location{Plasma::Types::Floating};
+
+        bool operator==(const SubtractedMaskSources &other) const {
+            return valid == other.valid
+                    && mask == other.mask
+                    && configGeometry == other.configGeometry
+                    && secondaryGeometry == other.secondaryGeometry
+                    && viewPosition == other.viewPosition
+                    && editShadow == other.editShadow
+                    && location == other.location;
+        }
+    };
+
+    //! subtractedMask() result and the sources it was calculated from
+    QRegion m_subtractedMask;
+    SubtractedMaskSources m_subtractedMaskSources;
+
+    //! frame masks for size, enabled borders and roundness
+    QHash<QString, QRegion> m_frameMasks;
+
+    //! setMask() calls are coalesced until the next event loop iteration
+    QTimer m_updateMaskTimer;
+
     QPointer<Latte::View> m_view;
 
     Plasma::Theme m_theme;
-    //only for the mask on disabled compositing, not to actually paint
-    Plasma::FrameSvg *m_background{nullptr};
 
     //only for the mask, not to actually paint
     Plasma::FrameSvg::EnabledBorders m_enabledBorders{Plasma::FrameSvg::AllBorders};
@@ -23,6 +23,7 @@
 
 // Qt
 #include <QDebug>
+#include <QSet>
 #include <QWindow>
 #include <QPainter>
 
@@ -58,16 +59,19 @@ public:
     }
 
     ~Private() {
-        // Do not call clearPixmaps() from here: it creates new QPixmap(),
-        // which causes a crash when application is stopping.
+        // Do not release any QPixmap from here, it
+        // causes a crash when application is stopping.
         freeX11Pixmaps();
     }
 
     void freeX11Pixmaps();
-    void freeWaylandBuffers();
-    void clearPixmaps();
     void setupPixmaps();
+    void setupWaylandBuffers();
     Qt::HANDLE createPixmap(const QPixmap &source);
+    unsigned long acquireX11Pixmap(const QPixmap &source, Plasma::FrameSvg::EnabledBorders enabledBorders);
+    void releaseX11Pixmap(qint64 key);
+    void releaseData(Plasma::FrameSvg::EnabledBorders enabledBorders);
+    void releaseUnusedData();
     void initPixmap(const QString &element);
     QPixmap initEmptyPixmap(const QSize &size);
     void updateShadow(const QWindow *window, Plasma::FrameSvg::EnabledBorders);
@@ -77,6 +81,7 @@ public:
     void clearShadowX11(const QWindow *window);
     void clearShadowWayland(const QWindow *window);
     void updateShadows();
+    void applyShadows();
     void windowDestroyed(QObject *deletedObject);
     void setupData(Plasma::FrameSvg::EnabledBorders enabledBorders);
 
@@ -93,6 +98,9 @@ public:
     QPixmap m_emptyVerticalPix;
     QPixmap m_emptyHorizontalPix;
 
+    //! empty pixmaps with the same size are shared, key: "widthxheight"
+    QHash<QString, QPixmap> m_emptyPixmaps;
+
 #if HAVE_X11
     //! xcb connection
     xcb_connection_t *_connection;
@@ -102,12 +110,30 @@ public:
     bool m_isX11;
 #endif
 
+    //! X11 pixmaps are uploaded once for each shadow tile and empty pixmap and they
+    //! are shared between all borders combinations, refs counts the combinations using them
+    struct X11Pixmap {
+        unsigned long handle{0};
+        int refs{0};
+    };
+
+    //! QPixmap::cacheKey() -> uploaded X11 pixmap
+    QHash<qint64, X11Pixmap> m_x11Pixmaps;
+    //! borders combination -> QPixmap::cacheKey()s of the X11 pixmaps it is using
+    QHash<Plasma::FrameSvg::EnabledBorders, QVector<qint64>> m_dataPixmaps;
+
     struct Wayland
     {
         KWayland::Client::ShadowManager *manager = nullptr;
         KWayland::Client::ShmPool *shmPool = nullptr;
 
+        //! ordered buffers of the current theme shadow tiles, they are shared by all views
         QList<KWayland::Client::Buffer::Ptr> shadowBuffers;
+        //! QPixmap::cacheKey() of a shadow tile -> its buffer
+        QHash<qint64, KWayland::Client::Buffer::Ptr> tileBuffers;
+
+        int createdBuffers{0};
+        qint64 createdBytes{0};
     };
     Wayland m_wayland;
 
@@ -166,9 +192,7 @@ void PanelShadows::removeWindow(const QWindow *window)
     disconnect(window, nullptr, this, nullptr);
     d->clearShadow(window);
 
-    if (d->m_windows.isEmpty()) {
-        d->clearPixmaps();
-    }
+    d->releaseUnusedData();
 }
 
 void PanelShadows::setEnabledBorders(const QWindow *window, Plasma::FrameSvg::EnabledBorders enabledBorders)
@@ -179,6 +203,7 @@ void PanelShadows::setEnabledBorders(const QWindow *window, Plasma::FrameSvg::En
 
     d->m_windows[window] = enabledBorders;
     d->updateShadow(window, enabledBorders);
+    d->releaseUnusedData();
 }
 
 
@@ -186,14 +211,41 @@ void PanelShadows::Private::windowDestroyed(QObject *deletedObject)
 {
     m_windows.remove(static_cast<QWindow *>(deletedObject));
 
-    if (m_windows.isEmpty()) {
-        clearPixmaps();
-    }
+    releaseUnusedData();
 }
 
 void PanelShadows::Private::updateShadows()
 {
+    //! shadow properties are always sent again because the theme margin hints may have
+    //! changed, unchanged tiles keep their uploaded pixmaps and buffers
     setupPixmaps();
+    applyShadows();
+}
+
+void PanelShadows::Private::applyShadows()
+{
+#if HAVE_X11
+    if (m_isX11) {
+        //! borders combinations in use are recreated from the refreshed tiles, unchanged
+        //! tiles keep their X11 pixmaps and only the changed ones are uploaded again
+        QHash<Plasma::FrameSvg::EnabledBorders, QVector<qint64>> previousDataPixmaps = m_dataPixmaps;
+        QList<Plasma::FrameSvg::EnabledBorders> usedBorders = data.keys();
+
+        data.clear();
+        m_dataPixmaps.clear();
+
+        for (const auto &enabledBorders : usedBorders) {
+            setupData(enabledBorders);
+        }
+
+        for (const auto &keys : previousDataPixmaps) {
+            for (const auto key : keys) {
+                releaseX11Pixmap(key);
+            }
+        }
+    }
+#endif
+
     QHash<const QWindow *, Plasma::FrameSvg::EnabledBorders>::const_iterator i;
 
     for (i = m_windows.constBegin(); i != m_windows.constEnd(); ++i) {
@@ -261,6 +313,70 @@ Qt::HANDLE PanelShadows::Private::createPixmap(const QPixmap &source)
 
 }
 
+unsigned long PanelShadows::Private::acquireX11Pixmap(const QPixmap &source, Plasma::FrameSvg::EnabledBorders enabledBorders)
+{
+    if (source.isNull()) {
+        return 0;
+    }
+
+    const qint64 key = source.cacheKey();
+
+    if (!m_x11Pixmaps.contains(key)) {
+        X11Pixmap x11Pixmap;
+        x11Pixmap.handle = reinterpret_cast<unsigned long>(createPixmap(source));
+        m_x11Pixmaps[key] = x11Pixmap;
+    }
+
+    m_x11Pixmaps[key].refs++;
+    m_dataPixmaps[enabledBorders] << key;
+
+    return m_x11Pixmaps[key].handle;
+}
+
+void PanelShadows::Private::releaseX11Pixmap(qint64 key)
+{
+#if HAVE_X11
+    if (!m_x11Pixmaps.contains(key)) {
+        return;
+    }
+
+    m_x11Pixmaps[key].refs--;
+
+    if (m_x11Pixmaps[key].refs <= 0) {
+        auto *display = QX11Info::display();
+
+        if (display && m_x11Pixmaps[key].handle) {
+            XFreePixmap(display, m_x11Pixmaps[key].handle);
+        }
+
+        m_x11Pixmaps.remove(key);
+    }
+#else
+    Q_UNUSED(key)
+#endif
+}
+
+void PanelShadows::Private::releaseData(Plasma::FrameSvg::EnabledBorders enabledBorders)
+{
+    for (const auto key : m_dataPixmaps.value(enabledBorders)) {
+        releaseX11Pixmap(key);
+    }
+
+    m_dataPixmaps.remove(enabledBorders);
+    data.remove(enabledBorders);
+}
+
+void PanelShadows::Private::releaseUnusedData()
+{
+    QList<Plasma::FrameSvg::EnabledBorders> usedBorders = m_windows.values();
+
+    for (const auto &enabledBorders : data.keys()) {
+        if (!usedBorders.contains(enabledBorders)) {
+            releaseData(enabledBorders);
+        }
+    }
+}
+
 void PanelShadows::Private::initPixmap(const QString &element)
 {
     m_shadowPixmaps << q->pixmap(element);
@@ -274,12 +390,20 @@ QPixmap PanelShadows::Private::initEmptyPixmap(const QSize &size)
         return QPixmap();
     }
 
+    const QString sizeKey = QString::number(size.width()) + "x" + QString::number(size.height());
+
+    if (m_emptyPixmaps.contains(sizeKey)) {
+        return m_emptyPixmaps[sizeKey];
+    }
+
     QPixmap tempEmptyPix(size);
 
     if (!size.isEmpty()) {
         tempEmptyPix.fill(Qt::transparent);
     }
 
+    m_emptyPixmaps[sizeKey] = tempEmptyPix;
+
     return tempEmptyPix;
 #else
     Q_UNUSED(size)
@@ -289,7 +413,11 @@ QPixmap PanelShadows::Private::initEmptyPixmap(const QSize &size)
 
 void PanelShadows::Private::setupPixmaps()
 {
-    clearPixmaps();
+    QList<QPixmap> previousPixmaps = m_shadowPixmaps;
+    bool changed{previousPixmaps.isEmpty()};
+
+    m_shadowPixmaps.clear();
+
     initPixmap(QStringLiteral("shadow-top"));
     initPixmap(QStringLiteral("shadow-topright"));
     initPixmap(QStringLiteral("shadow-right"));
@@ -299,6 +427,19 @@ void PanelShadows::Private::setupPixmaps()
     initPixmap(QStringLiteral("shadow-left"));
     initPixmap(QStringLiteral("shadow-topleft"));
 
+    //! unchanged tiles keep their previous pixmaps in order to reuse their uploaded X11 pixmaps
+    if (previousPixmaps.count() == m_shadowPixmaps.count()) {
+        for (int i = 0; i < m_shadowPixmaps.count(); ++i) {
+            if (previousPixmaps[i].toImage() == m_shadowPixmaps[i].toImage()) {
+                m_shadowPixmaps[i] = previousPixmaps[i];
+            } else {
+                changed = true;
+            }
+        }
+    } else {
+        changed = true;
+    }
+
     m_emptyCornerPix = initEmptyPixmap(QSize(1, 1));
     m_emptyCornerLeftPix = initEmptyPixmap(QSize(q->elementSize(QStringLiteral("shadow-topleft")).width(), 1));
     m_emptyCornerTopPix = initEmptyPixmap(QSize(1, q->elementSize(QStringLiteral("shadow-topleft")).height()));
@@ -307,11 +448,66 @@ void PanelShadows::Private::setupPixmaps()
     m_emptyVerticalPix = initEmptyPixmap(QSize(1, q->elementSize(QStringLiteral("shadow-left")).height()));
     m_emptyHorizontalPix = initEmptyPixmap(QSize(q->elementSize(QStringLiteral("shadow-top")).width(), 1));
 
-    if (m_wayland.shmPool) {
-        for (auto it = m_shadowPixmaps.constBegin(); it != m_shadowPixmaps.constEnd(); ++it) {
-            m_wayland.shadowBuffers << m_wayland.shmPool->createBuffer(it->toImage());
+    //! empty pixmaps of sizes that the current theme is not using any more are dropped
+    QSet<qint64> usedEmptyPixmaps{m_emptyCornerPix.cacheKey(), m_emptyCornerLeftPix.cacheKey(),
+                                  m_emptyCornerTopPix.cacheKey(), m_emptyCornerRightPix.cacheKey(),
+                                  m_emptyCornerBottomPix.cacheKey(), m_emptyVerticalPix.cacheKey(),
+                                  m_emptyHorizontalPix.cacheKey()};
+
+    for (auto it = m_emptyPixmaps.begin(); it != m_emptyPixmaps.end();) {
+        if (usedEmptyPixmaps.contains(it.value().cacheKey())) {
+            ++it;
+        } else {
+            it = m_emptyPixmaps.erase(it);
         }
     }
+
+    if (m_wayland.shmPool && (changed || m_wayland.shadowBuffers.isEmpty())) {
+        setupWaylandBuffers();
+    }
+}
+
+void PanelShadows::Private::setupWaylandBuffers()
+{
+    QHash<qint64, KWayland::Client::Buffer::Ptr> previousTileBuffers = m_wayland.tileBuffers;
+
+    m_wayland.shadowBuffers.clear();
+    m_wayland.tileBuffers.clear();
+
+    for (const auto &pixmap : m_shadowPixmaps) {
+        const qint64 key = pixmap.cacheKey();
+        KWayland::Client::Buffer::Ptr buffer;
+
+        if (previousTileBuffers.contains(key)) {
+            buffer = previousTileBuffers.take(key);
+        } else if (m_wayland.tileBuffers.contains(key)) {
+            buffer = m_wayland.tileBuffers[key];
+        } else {
+            QImage image = pixmap.toImage();
+            buffer = m_wayland.shmPool->createBuffer(image);
+
+            //! buffers are kept for all views, so the pool must not reuse them
+            if (auto strongBuffer = buffer.toStrongRef()) {
+                strongBuffer->setUsed(true);
+            }
+
+            m_wayland.createdBuffers++;
+            m_wayland.createdBytes += image.byteCount();
+        }
+
+        m_wayland.tileBuffers[key] = buffer;
+        m_wayland.shadowBuffers << buffer;
+    }
+
+    //! buffers of tiles that changed are given back to the pool
+    for (const auto &buffer : previousTileBuffers) {
+        if (auto strongBuffer = buffer.toStrongRef()) {
+            strongBuffer->setUsed(false);
+        }
+    }
+
+    qDebug() << "panel shadows, wayland buffers created ::: " << m_wayland.createdBuffers
+             << " bytes ::: " << m_wayland.createdBytes;
 }
 
 
@@ -325,78 +521,78 @@ void PanelShadows::Private::setupData(Plasma::FrameSvg::EnabledBorders enabledBo
 
     //shadow-top
     if (enabledBorders & Plasma::FrameSvg::TopBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[0]));
+        data[enabledBorders] << acquireX11Pixmap(m_shadowPixmaps[0], enabledBorders);
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyHorizontalPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyHorizontalPix, enabledBorders);
     }
 
     //shadow-topright
     if (enabledBorders & Plasma::FrameSvg::TopBorder &&
         enabledBorders & Plasma::FrameSvg::RightBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[1]));
+        data[enabledBorders] << acquireX11Pixmap(m_shadowPixmaps[1], enabledBorders);
     } else if (enabledBorders & Plasma::FrameSvg::TopBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerTopPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerTopPix, enabledBorders);
     } else if (enabledBorders & Plasma::FrameSvg::RightBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerRightPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerRightPix, enabledBorders);
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerPix, enabledBorders);
     }
 
     //shadow-right
     if (enabledBorders & Plasma::FrameSvg::RightBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[2]));
+        data[enabledBorders] << acquireX11Pixmap(m_shadowPixmaps[2], enabledBorders);
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyVerticalPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyVerticalPix, enabledBorders);
     }
 
     //shadow-bottomright
     if (enabledBorders & Plasma::FrameSvg::BottomBorder &&
         enabledBorders & Plasma::FrameSvg::RightBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[3]));
+        data[enabledBorders] << acquireX11Pixmap(m_shadowPixmaps[3], enabledBorders);
     } else if (enabledBorders & Plasma::FrameSvg::BottomBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerBottomPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerBottomPix, enabledBorders);
     } else if (enabledBorders & Plasma::FrameSvg::RightBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerRightPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerRightPix, enabledBorders);
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerPix, enabledBorders);
     }
 
     //shadow-bottom
     if (enabledBorders & Plasma::FrameSvg::BottomBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[4]));
+        data[enabledBorders] << acquireX11Pixmap(m_shadowPixmaps[4], enabledBorders);
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyHorizontalPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyHorizontalPix, enabledBorders);
     }
 
     //shadow-bottomleft
     if (enabledBorders & Plasma::FrameSvg::BottomBorder &&
         enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[5]));
+        data[enabledBorders] << acquireX11Pixmap(m_shadowPixmaps[5], enabledBorders);
     } else if (enabledBorders & Plasma::FrameSvg::BottomBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerBottomPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerBottomPix, enabledBorders);
     } else if (enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerLeftPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerLeftPix, enabledBorders);
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerPix, enabledBorders);
     }
 
     //shadow-left
     if (enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[6]));
+        data[enabledBorders] << acquireX11Pixmap(m_shadowPixmaps[6], enabledBorders);
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyVerticalPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyVerticalPix, enabledBorders);
     }
 
     //shadow-topleft
     if (enabledBorders & Plasma::FrameSvg::TopBorder &&
         enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_shadowPixmaps[7]));
+        data[enabledBorders] << acquireX11Pixmap(m_shadowPixmaps[7], enabledBorders);
     } else if (enabledBorders & Plasma::FrameSvg::TopBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerTopPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerTopPix, enabledBorders);
     } else if (enabledBorders & Plasma::FrameSvg::LeftBorder) {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerLeftPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerLeftPix, enabledBorders);
     } else {
-        data[enabledBorders] << reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix));
+        data[enabledBorders] << acquireX11Pixmap(m_emptyCornerPix, enabledBorders);
     }
 
 #endif
@@ -470,66 +666,18 @@ void PanelShadows::Private::freeX11Pixmaps()
         return;
     }
 
-    for (const QPixmap &pixmap : m_shadowPixmaps) {
-        if (!pixmap.isNull()) {
-            XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(pixmap)));
+    for (const auto &x11Pixmap : m_x11Pixmaps) {
+        if (x11Pixmap.handle) {
+            XFreePixmap(display, x11Pixmap.handle);
         }
     }
 
-    if (!m_emptyCornerPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerPix)));
-    }
-
-    if (!m_emptyCornerBottomPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerBottomPix)));
-    }
-
-    if (!m_emptyCornerLeftPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerLeftPix)));
-    }
-
-    if (!m_emptyCornerRightPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerRightPix)));
-    }
-
-    if (!m_emptyCornerTopPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyCornerTopPix)));
-    }
-
-    if (!m_emptyVerticalPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyVerticalPix)));
-    }
-
-    if (!m_emptyHorizontalPix.isNull()) {
-        XFreePixmap(display, reinterpret_cast<unsigned long>(createPixmap(m_emptyHorizontalPix)));
-    }
+    m_x11Pixmaps.clear();
+    m_dataPixmaps.clear();
 
 #endif
 }
 
-void PanelShadows::Private::clearPixmaps()
-{
-#if HAVE_X11
-    freeX11Pixmaps();
-
-    m_emptyCornerPix = QPixmap();
-    m_emptyCornerBottomPix = QPixmap();
-    m_emptyCornerLeftPix = QPixmap();
-    m_emptyCornerRightPix = QPixmap();
-    m_emptyCornerTopPix = QPixmap();
-    m_emptyVerticalPix = QPixmap();
-    m_emptyHorizontalPix = QPixmap();
-#endif
-    freeWaylandBuffers();
-    m_shadowPixmaps.clear();
-    data.clear();
-}
-
-void PanelShadows::Private::freeWaylandBuffers()
-{
-    m_wayland.shadowBuffers.clear();
-}
-
 void PanelShadows::Private::updateShadow(const QWindow *window, Plasma::FrameSvg::EnabledBorders enabledBorders)
 {
 #if HAVE_X11
@@ -741,7 +889,8 @@ void PanelShadows::Private::setupWaylandIntegration()
     connect(registry, &Registry::shadowAnnounced, q,
     [this, registry](quint32 name, quint32 version) {
         m_wayland.manager = registry->createShadowManager(name, version, q);
-        updateShadows();
+        setupPixmaps();
+        applyShadows();
     }, Qt::QueuedConnection
            );
     connect(registry, &Registry::shmAnnounced, q,
@@ -22,6 +22,7 @@
 // local
 #include "effects.h"
 #include "view.h"
+#include "windowtransaction.h"
 #include "../lattecorona.h"
 #include "../screenpool.h"
 #include "../settings/universalsettings.h"
@@ -46,6 +47,13 @@ Positioner::Positioner(Latte::View *parent)
     m_screenSyncTimer.setInterval(2000);
     connect(&m_screenSyncTimer, &QTimer::timeout, this, &Positioner::reconsiderScreen);
 
+    //! screens are reconsidered when the window system reports screen changes,
+    //! under Wayland outputs are reported through the same QScreen signals.
+    //! Added screens and primary screen changes are tracked through screenChanged()
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, [&]() {
+        m_screenSyncTimer.start();
+    });
+
     //! under X11 it was identified that windows many times especially under screen changes
     //! don't end up at the correct position and size. This timer will enforce repositionings
     //! and resizes every 500ms if the window hasn't end up to correct values and until this
@@ -54,13 +62,27 @@ Positioner::Positioner(Latte::View *parent)
     m_validateGeometryTimer.setInterval(500);
     connect(&m_validateGeometryTimer, &QTimer::timeout, this, &Positioner::syncGeometry);
 
+    m_tightWindowTimer.setSingleShot(true);
+    m_tightWindowTimer.setInterval(1000);
+    connect(&m_tightWindowTimer, &QTimer::timeout, this, [&]() {
+        if (tightWindowCanBeUsed()) {
+            m_tightWindow = true;
+            applyWindowGeometry();
+
+            //! estimated from the window size for a 32bit surface, it is not a measured value
+            qDebug() << "tight window enabled, estimated surface bytes ::: full:" << m_fullGeometry.width() * m_fullGeometry.height() * 4
+                     << " tight:" << m_validGeometry.width() * m_validGeometry.height() * 4;
+        }
+    });
+
     auto *latteCorona = qobject_cast<Latte::Corona *>(m_view->corona());
 
     if (latteCorona) {
-        m_screenSyncTimer.setInterval(qMax(latteCorona->universalSettings()->screenTrackerInterval() - 500, 1000));
-        connect(latteCorona->universalSettings(), &UniversalSettings::screenTrackerIntervalChanged, this, [this, latteCorona]() {
-            m_screenSyncTimer.setInterval(qMax(latteCorona->universalSettings()->screenTrackerInterval() - 500, 1000));
-        });
+        updateScreenSyncInterval();
+        connect(latteCorona->universalSettings(), &UniversalSettings::screenTrackerIntervalChanged, this, &Positioner::updateScreenSyncInterval);
+        connect(latteCorona->universalSettings(), &UniversalSettings::screenTrackerPollingChanged, this, &Positioner::updateScreenSyncInterval);
+
+        connect(latteCorona->universalSettings(), &UniversalSettings::tightViewWindowsChanged, this, &Positioner::updateTightWindow);
 
         connect(latteCorona, &Latte::Corona::viewLocationChanged, this, [&]() {
             //! check if an edge has been freed for a primary dock
@@ -80,6 +102,18 @@ Positioner::~Positioner()
 
     m_screenSyncTimer.stop();
     m_validateGeometryTimer.stop();
+    m_tightWindowTimer.stop();
+}
+
+void Positioner::updateScreenSyncInterval()
+{
+    auto *latteCorona = qobject_cast<Latte::Corona *>(m_view->corona());
+
+    if (!latteCorona) {
+        return;
+    }
+
+    m_screenSyncTimer.setInterval(latteCorona->universalSettings()->viewsScreenTrackerDelay());
 }
 
 void Positioner::init()
@@ -116,6 +150,19 @@ void Positioner::init()
         }
     });
 
+    //! fitting window to its contents
+    connect(m_view, &Latte::View::containsDragChanged, this, &Positioner::updateTightWindow);
+    connect(m_view, &Latte::View::inEditModeChanged, this, &Positioner::updateTightWindow);
+    connect(m_view, &Latte::View::localGeometryChanged, this, &Positioner::updateTightWindow);
+    connect(m_view, &Latte::View::visibilityChanged, this, [&]() {
+        if (m_view->visibility()) {
+            connect(m_view->visibility(), &VisibilityManager::containsMouseChanged, this, &Positioner::updateTightWindow, Qt::UniqueConnection);
+            connect(m_view->visibility(), &VisibilityManager::modeChanged, this, &Positioner::updateTightWindow, Qt::UniqueConnection);
+        }
+
+        updateTightWindow();
+    });
+
     connect(m_view->effects(), &Latte::ViewPart::Effects::drawShadowsChanged, this, [&]() {
         if (!m_view->behaveAsPlasmaPanel()) {
             syncGeometry();
@@ -376,6 +423,14 @@ void Positioner::syncGeometry()
         resizeWindow(availableScreenRect);
         updatePosition(availableScreenRect);
 
+        if (m_view->formFactor() == Plasma::Types::Horizontal) {
+            //! it is sent when the new geometry has been applied to the window, otherwise
+            //! other views would recalculate their geometries against the old one
+            m_windowSizeChangePending = true;
+        }
+
+        applyWindowGeometry();
+
         qDebug() << "syncGeometry() calculations for screen: " << m_view->screen()->name() << " _ " << m_view->screen()->geometry();
         qDebug() << "syncGeometry() calculations for edge: " << m_view->location();
     }
@@ -460,7 +515,7 @@ void Positioner::updatePosition(QRect availableScreenRect)
                             screenGeometry.y() + screenGeometry.height() - cleanThickness
                            };
             } else {
-                position = {screenGeometry.x(), screenGeometry.y() + screenGeometry.height() - m_view->height()};
+                position = {screenGeometry.x(), screenGeometry.y() + screenGeometry.height() - m_fullGeometry.height()};
             }
 
             break;
@@ -471,7 +526,7 @@ void Positioner::updatePosition(QRect availableScreenRect)
                             availableScreenRect.y() + length(availableScreenRect.height())
                            };
             } else {
-                position = {availableScreenRect.right() - m_view->width() + 1, availableScreenRect.y()};
+                position = {availableScreenRect.right() - m_fullGeometry.width() + 1, availableScreenRect.y()};
             }
 
             break;
@@ -490,13 +545,7 @@ void Positioner::updatePosition(QRect availableScreenRect)
                        << m_view->location();
     }
 
-    m_validGeometry.setTopLeft(position);
-
-    m_view->setPosition(position);
-
-    if (m_view->surface()) {
-        m_view->surface()->setPosition(position);
-    }
+    m_fullGeometry.moveTopLeft(position);
 }
 
 void Positioner::resizeWindow(QRect availableScreenRect)
@@ -517,15 +566,108 @@ void Positioner::resizeWindow(QRect availableScreenRect)
         }
     }
 
-    m_validGeometry.setSize(size);
+    m_fullGeometry.setSize(size);
+}
+
+void Positioner::applyWindowGeometry()
+{
+    QRect windowGeometry = m_tightWindow ? tightGeometry() : m_fullGeometry;
+
+    m_validGeometry = windowGeometry;
+
+    const QPoint contentOffset = m_fullGeometry.topLeft() - windowGeometry.topLeft();
+    const QSize contentSize = m_fullGeometry.size();
+
+    m_view->windowTransaction()->schedule(WindowTransaction::Geometry, [this, windowGeometry, contentOffset, contentSize]() {
+        //! the root item keeps always the full geometry in order for the contents to remain at place
+        m_view->setContentGeometry(contentOffset, contentSize);
+
+        m_view->setMinimumSize(windowGeometry.size());
+        m_view->setMaximumSize(windowGeometry.size());
+        m_view->resize(windowGeometry.size());
 
-    m_view->setMinimumSize(size);
-    m_view->setMaximumSize(size);
-    m_view->resize(size);
+        m_view->setPosition(windowGeometry.topLeft());
+
+        if (m_view->surface()) {
+            m_view->surface()->setPosition(windowGeometry.topLeft());
+        }
+
+        if (m_windowSizeChangePending) {
+            m_windowSizeChangePending = false;
+            emit windowSizeChanged();
+        }
+
+        emit windowGeometryCommitted();
+    });
+}
+
+bool Positioner::tightWindowCanBeUsed() const
+{
+    auto *latteCorona = qobject_cast<Latte::Corona *>(m_view->corona());
+
+    if (!latteCorona || !latteCorona->universalSettings()->tightViewWindows()) {
+        return false;
+    }
+
+    //! the full length is needed for zoom, drag and drop and edit mode, views that hide
+    //! are also excluded because their screen edge must remain responsive at full length
+    return !m_view->behaveAsPlasmaPanel()
+            && !m_view->inEditMode()
+            && !m_view->containsDrag()
+            && m_view->visibility()
+            && !m_view->visibility()->containsMouse()
+            && (m_view->visibility()->mode() == Latte::Types::AlwaysVisible
+                || m_view->visibility()->mode() == Latte::Types::WindowsGoBelow)
+            && !m_view->localGeometry().isEmpty()
+            && !m_goToScreen && m_goToLocation == Plasma::Types::Floating && m_moveToLayout.isEmpty();
+}
+
+void Positioner::updateTightWindow()
+{
+    if (m_inDelete || !m_fullGeometry.isValid()) {
+        return;
+    }
+
+    if (!tightWindowCanBeUsed()) {
+        m_tightWindowTimer.stop();
+
+        if (m_tightWindow) {
+            m_tightWindow = false;
+            applyWindowGeometry();
+
+            qDebug() << "tight window disabled, estimated surface bytes ::: " << m_fullGeometry.width() * m_fullGeometry.height() * 4;
+        }
+
+        return;
+    }
+
+    if (!m_tightWindow) {
+        m_tightWindowTimer.start();
+    } else if (m_validGeometry != tightGeometry()) {
+        applyWindowGeometry();
+    }
+}
+
+//! the view contents as they are reported from QML plus the zoom margin
+QRect Positioner::tightGeometry() const
+{
+    QRect contents = m_view->localGeometry();
+    int margin = qMax(0, m_view->maxThickness() - m_view->normalThickness());
+    QRect tight = m_fullGeometry;
 
     if (m_view->formFactor() == Plasma::Types::Horizontal) {
-        emit windowSizeChanged();
+        int start = qMax(0, contents.x() - margin);
+        int end = qMin(m_fullGeometry.width(), contents.x() + contents.width() + margin);
+        tight.setX(m_fullGeometry.x() + start);
+        tight.setWidth(end - start);
+    } else {
+        int start = qMax(0, contents.y() - margin);
+        int end = qMin(m_fullGeometry.height(), contents.y() + contents.height() + margin);
+        tight.setY(m_fullGeometry.y() + start);
+        tight.setHeight(end - start);
     }
+
+    return tight.isEmpty() ? m_fullGeometry : tight;
 }
 
 void Positioner::updateFormFactor()
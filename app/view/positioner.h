@@ -72,6 +72,7 @@ signals:
     void edgeChanged();
     void screenGeometryChanged();
     void windowSizeChanged();
+    void windowGeometryCommitted();
 
     //! these two signals are used from config ui and containment ui
     //! in order to orchestrate an animated hiding/showing of dock
@@ -90,6 +91,8 @@ signals:
 private slots:
     void screenChanged(QScreen *screen);
     void validateDockGeometry();
+    void updateTightWindow();
+    void updateScreenSyncInterval();
 
 private:
     void init();
@@ -98,14 +101,23 @@ private:
 
     void updateFormFactor();
     void updatePosition(QRect availableScreenRect = QRect());
+    void applyWindowGeometry();
+
+    bool tightWindowCanBeUsed() const;
 
     QRect maximumNormalGeometry();
+    QRect tightGeometry() const;
 
 private:
     bool m_inDelete{false};
+    bool m_tightWindow{false};
+    //! windowSizeChanged is sent when the pending geometry is committed
+    bool m_windowSizeChangePending{false};
 
     //! it is used in order to enforce X11 to never miss window geometry
     QRect m_validGeometry;
+    //! the geometry of the window when it is not fitted to its contents
+    QRect m_fullGeometry;
 
     QPointer<Latte::View> m_view;
 
@@ -114,6 +126,8 @@ private:
     QTimer m_screenSyncTimer;
 
     QTimer m_validateGeometryTimer;
+    //! fitting the window to its contents is delayed in order for zoom animations to finish
+    QTimer m_tightWindowTimer;
 
     //!used at sliding out/in animation
     QString m_moveToLayout;
@@ -24,9 +24,11 @@
 #include "../lattecorona.h"
 
 // Qt
+#include <QCoreApplication>
 #include <QDebug>
+#include <QPainter>
+#include <QPointer>
 #include <QSurfaceFormat>
-#include <QQuickView>
 #include <QTimer>
 
 // KDE
@@ -37,14 +39,85 @@
 // X11
 #include <NETWM>
 
+#define GHOSTWINDOWSPOOLSIZE 4
+
 namespace Latte {
 namespace ViewPart {
 
-ScreenEdgeGhostWindow::ScreenEdgeGhostWindow(Latte::View *view) :
-    m_latteView(view)
+typedef QList<QPointer<ScreenEdgeGhostWindow>> GhostWindowsPool;
+Q_GLOBAL_STATIC(GhostWindowsPool, idleGhostWindows)
+
+ScreenEdgeGhostWindow *ScreenEdgeGhostWindow::acquire(Latte::View *view)
+{
+    if (!view) {
+        return nullptr;
+    }
+
+    ScreenEdgeGhostWindow *window{nullptr};
+
+    idleGhostWindows->removeAll(nullptr);
+
+    for (const auto &idle : *idleGhostWindows) {
+        if (idle->screen() == view->screen()) {
+            window = idle;
+            break;
+        }
+    }
+
+    if (!window && !idleGhostWindows->isEmpty()) {
+        window = idleGhostWindows->first();
+    }
+
+    if (window) {
+        idleGhostWindows->removeAll(window);
+    } else {
+        window = new ScreenEdgeGhostWindow();
+    }
+
+    window->setParentView(view);
+
+    return window;
+}
+
+void ScreenEdgeGhostWindow::release(ScreenEdgeGhostWindow *window)
 {
-    setColor(QColor(Qt::transparent));
-    setDefaultAlphaBuffer(true);
+    if (!window) {
+        return;
+    }
+
+    window->setParentView(nullptr);
+
+    idleGhostWindows->removeAll(nullptr);
+
+    if (idleGhostWindows->count() >= GHOSTWINDOWSPOOLSIZE) {
+        window->deleteLater();
+        return;
+    }
+
+    static bool cleanupConnected{false};
+
+    if (!cleanupConnected) {
+        //! idle windows must be released before the application is destroyed
+        cleanupConnected = true;
+        QObject::connect(qApp, &QCoreApplication::aboutToQuit, qApp, []() {
+            for (const auto &idle : *idleGhostWindows) {
+                if (idle) {
+                    delete idle;
+                }
+            }
+
+            idleGhostWindows->clear();
+        });
+    }
+
+    idleGhostWindows->append(window);
+}
+
+ScreenEdgeGhostWindow::ScreenEdgeGhostWindow()
+{
+    QSurfaceFormat format = this->format();
+    format.setAlphaBufferSize(8);
+    setFormat(format);
 
     setFlags(Qt::FramelessWindowHint
              | Qt::WindowStaysOnTopHint
@@ -67,19 +140,10 @@ ScreenEdgeGhostWindow::ScreenEdgeGhostWindow(Latte::View *view) :
         }
     });
 
-    connect(this, &QQuickView::xChanged, this, &ScreenEdgeGhostWindow::startGeometryTimer);
-    connect(this, &QQuickView::yChanged, this, &ScreenEdgeGhostWindow::startGeometryTimer);
-    connect(this, &QQuickView::widthChanged, this, &ScreenEdgeGhostWindow::startGeometryTimer);
-    connect(this, &QQuickView::heightChanged, this, &ScreenEdgeGhostWindow::startGeometryTimer);
-
-    connect(m_latteView, &Latte::View::absoluteGeometryChanged, this, &ScreenEdgeGhostWindow::updateGeometry);
-    connect(m_latteView, &Latte::View::screenGeometryChanged, this, &ScreenEdgeGhostWindow::updateGeometry);
-    connect(m_latteView, &Latte::View::locationChanged, this, &ScreenEdgeGhostWindow::updateGeometry);
-    connect(m_latteView, &QQuickView::screenChanged, this, [this]() {
-        setScreen(m_latteView->screen());
-        updateGeometry();
-    });
-
+    connect(this, &QWindow::xChanged, this, &ScreenEdgeGhostWindow::startGeometryTimer);
+    connect(this, &QWindow::yChanged, this, &ScreenEdgeGhostWindow::startGeometryTimer);
+    connect(this, &QWindow::widthChanged, this, &ScreenEdgeGhostWindow::startGeometryTimer);
+    connect(this, &QWindow::heightChanged, this, &ScreenEdgeGhostWindow::startGeometryTimer);
 
     if (!KWindowSystem::isPlatformWayland()) {
         //! IMPORTANT!!! ::: This fixes a bug when closing an Activity all views from all Activities are
@@ -93,7 +157,7 @@ ScreenEdgeGhostWindow::ScreenEdgeGhostWindow(Latte::View *view) :
             if (!m_inDelete && m_latteView && m_latteView->layout() && !isVisible()) {
                 m_visibleHackTimer1.start();
                 m_visibleHackTimer2.start();
-            } else if (!m_inDelete) {
+            } else if (!m_inDelete && isVisible()) {
                 //! For some reason when the window is hidden in the edge under X11 afterwards
                 //! is losing its window flags
                 KWindowSystem::setType(winId(), NET::Dock);
@@ -121,12 +185,6 @@ ScreenEdgeGhostWindow::ScreenEdgeGhostWindow(Latte::View *view) :
         });
     }
 
-    setupWaylandIntegration();
-
-    setScreen(m_latteView->screen());
-    setVisible(true);
-    updateGeometry();
-    hideWithMask();
 }
 
 ScreenEdgeGhostWindow::~ScreenEdgeGhostWindow()
@@ -141,14 +199,68 @@ ScreenEdgeGhostWindow::~ScreenEdgeGhostWindow()
         disconnect(c);
     }
 
+    for (auto &c : connectionsView) {
+        disconnect(c);
+    }
+
     if (m_shellSurface) {
         delete m_shellSurface;
     }
 }
 
+void ScreenEdgeGhostWindow::setParentView(Latte::View *view)
+{
+    if (m_latteView == view) {
+        return;
+    }
+
+    for (auto &c : connectionsView) {
+        disconnect(c);
+    }
+
+    connectionsView.clear();
+
+    m_latteView = view;
+
+    m_fixGeometryTimer.stop();
+    m_delayedMouseTimer.stop();
+    m_delayedContainsMouse = false;
+    m_containsMouse = false;
+
+    if (!m_latteView) {
+        m_visibleHackTimer1.stop();
+        m_visibleHackTimer2.stop();
+        m_calculatedGeometry = QRect();
+        setVisible(false);
+
+        //! the wayland surface is not valid after hiding, it is recreated when the window is reused
+        if (m_shellSurface) {
+            delete m_shellSurface;
+            m_shellSurface = nullptr;
+        }
+
+        return;
+    }
+
+    connectionsView << connect(m_latteView, &Latte::View::absoluteGeometryChanged, this, &ScreenEdgeGhostWindow::updateGeometry);
+    connectionsView << connect(m_latteView, &Latte::View::screenGeometryChanged, this, &ScreenEdgeGhostWindow::updateGeometry);
+    connectionsView << connect(m_latteView, &Latte::View::locationChanged, this, &ScreenEdgeGhostWindow::updateGeometry);
+    connectionsView << connect(m_latteView, &QQuickView::screenChanged, this, [this]() {
+        setScreen(m_latteView->screen());
+        updateGeometry();
+    });
+
+    setupWaylandIntegration();
+
+    setScreen(m_latteView->screen());
+    setVisible(true);
+    updateGeometry();
+    hideWithMask();
+}
+
 int ScreenEdgeGhostWindow::location()
 {
-    return (int)m_latteView->location();
+    return m_latteView ? (int)m_latteView->location() : (int)Plasma::Types::Floating;
 }
 
 Latte::View *ScreenEdgeGhostWindow::parentView()
@@ -163,12 +275,16 @@ KWayland::Client::PlasmaShellSurface *ScreenEdgeGhostWindow::surface()
 
 void ScreenEdgeGhostWindow::updateGeometry()
 {
+    if (!m_latteView) {
+        return;
+    }
+
     QRect newGeometry;
     int thickness;
     if (KWindowSystem::compositingActive()) {
-        thickness == 4;
+        thickness = 4;
     } else {
-        thickness == 2;
+        thickness = 2;
     };
 
     if (m_latteView->location() == Plasma::Types::BottomEdge) {
@@ -279,7 +395,16 @@ bool ScreenEdgeGhostWindow::event(QEvent *e)
         }
     }
 
-    return QQuickView::event(e);
+    return QRasterWindow::event(e);
+}
+
+void ScreenEdgeGhostWindow::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(QRect(QPoint(0, 0), size()), Qt::transparent);
 }
 
 void ScreenEdgeGhostWindow::hideWithMask()
@@ -22,7 +22,7 @@
 
 // Qt
 #include <QObject>
-#include <QQuickView>
+#include <QRasterWindow>
 #include <QTimer>
 
 namespace KWayland {
@@ -54,15 +54,24 @@ namespace ViewPart {
 //!
 //! KDE BUGS: https://bugs.kde.org/show_bug.cgi?id=382219
 //!           https://bugs.kde.org/show_bug.cgi?id=392464
+//!
+//! The window paints nothing, so it is a plain raster window without a scene graph.
+//! Ghost windows are pooled and reused from views and visibility modes instead of
+//! creating a new native window each time a view needs one.
 
-class ScreenEdgeGhostWindow : public QQuickView
+class ScreenEdgeGhostWindow : public QRasterWindow
 {
     Q_OBJECT
 
 public:
-    ScreenEdgeGhostWindow(Latte::View *view);
     ~ScreenEdgeGhostWindow() override;
 
+    //! provides an idle ghost window of the pool, preferably one that was used
+    //! at the same screen edge, or creates a new one
+    static ScreenEdgeGhostWindow *acquire(Latte::View *view);
+    //! the window is hidden and kept in the pool in order to be reused
+    static void release(ScreenEdgeGhostWindow *window);
+
     bool containsMouse() const;
 
     int location();
@@ -79,6 +88,7 @@ signals:
 
 protected:
     bool event(QEvent *ev) override;
+    void paintEvent(QPaintEvent *event) override;
 
 private slots:
     void startGeometryTimer();
@@ -86,7 +96,10 @@ private slots:
     void fixGeometry();
 
 private:
+    ScreenEdgeGhostWindow();
+
     void setContainsMouse(bool contains);
+    void setParentView(Latte::View *view);
     void setupWaylandIntegration();
 
 private:
@@ -105,6 +118,8 @@ private:
     QTimer m_visibleHackTimer2;
     //! Connections for the KWin visibility hack
     QList<QMetaObject::Connection> connectionsHack;
+    //! Connections with the view that is currently using the window
+    QList<QMetaObject::Connection> connectionsView;
 
     Latte::View *m_latteView{nullptr};
 
@@ -25,6 +25,7 @@
 #include "effects.h"
 #include "positioner.h"
 #include "visibilitymanager.h"
+#include "windowtransaction.h"
 #include "settings/primaryconfigview.h"
 #include "settings/secondaryconfigview.h"
 #include "../indicator/factory.h"
@@ -67,6 +68,7 @@ namespace Latte {
 View::View(Plasma::Corona *corona, QScreen *targetScreen, bool byPassWM)
     : PlasmaQuick::ContainmentView(corona),
       m_contextMenu(new ViewPart::ContextMenu(this)),
+      m_windowTransaction(new ViewPart::WindowTransaction(this)),
       m_effects(new ViewPart::Effects(this)),
       m_positioner(new ViewPart::Positioner(this)) //needs to be created after Effects because it catches some of its signals
 {   
@@ -159,7 +161,12 @@ View::~View()
         m_indicator->unloadIndicators();
     }
 
-    disconnect(m_corona, &Latte::Corona::availableScreenRectChangedFrom, this, &View::availableScreenRectChangedFrom);
+    //! parts that are deleted afterwards must release their window resources immediately
+    if (m_windowTransaction) {
+        m_windowTransaction->close();
+    }
+
+    disconnect(m_corona, &Latte::Corona::availableScreenRectChangedOn, this, &View::availableScreenRectChangedOn);
     disconnect(containment(), SIGNAL(statusChanged(Plasma::Types::ItemStatus)), this, SLOT(statusChanged(Plasma::Types::ItemStatus)));
 
     qDebug() << "dock view deleting...";
@@ -204,6 +211,10 @@ View::~View()
     if (m_windowsTracker) {
         delete m_windowsTracker;
     }
+
+    if (m_windowTransaction) {
+        delete m_windowTransaction;
+    }
 }
 
 void View::init()
@@ -217,7 +228,7 @@ void View::init()
     connect(this, &QQuickWindow::heightChanged, this, &View::heightChanged);
     connect(this, &QQuickWindow::heightChanged, this, &View::updateAbsoluteGeometry);
 
-    connect(m_corona, &Latte::Corona::availableScreenRectChangedFrom, this, &View::availableScreenRectChangedFrom);
+    connect(m_corona, &Latte::Corona::availableScreenRectChangedOn, this, &View::availableScreenRectChangedOn);
 
     connect(this, &View::byPassWMChanged, this, &View::saveConfig);
     connect(this, &View::isPreferredForShortcutsChanged, this, &View::saveConfig);
@@ -228,6 +239,18 @@ void View::init()
         emit m_corona->availableScreenRectChangedFrom(this);
     });
 
+    //! they are used from corona available screen region calculations, other views
+    //! are informed only when the available screen geometries really changed
+    connect(this, &View::alignmentChanged, this, [&]() {
+        m_corona->updateAvailableScreenCache(this);
+    });
+    connect(this, &View::behaveAsPlasmaPanelChanged, this, [&]() {
+        m_corona->updateAvailableScreenCache(this);
+    });
+    connect(this, &View::maxLengthChanged, this, [&]() {
+        m_corona->updateAvailableScreenCache(this);
+    });
+
     connect(m_effects, &ViewPart::Effects::innerShadowChanged, this, [&]() {
         emit m_corona->availableScreenRectChangedFrom(this);
     });
@@ -285,7 +308,7 @@ bool View::inDelete() const
 
 void View::disconnectSensitiveSignals()
 {
-    disconnect(m_corona, &Latte::Corona::availableScreenRectChangedFrom, this, &View::availableScreenRectChangedFrom);
+    disconnect(m_corona, &Latte::Corona::availableScreenRectChangedOn, this, &View::availableScreenRectChangedOn);
     setLayout(nullptr);
 
     if (m_windowsTracker) {
@@ -293,13 +316,17 @@ void View::disconnectSensitiveSignals()
     }
 }
 
-void View::availableScreenRectChangedFrom(View *origin)
+void View::availableScreenRectChangedOn(QScreen *scr, View *origin)
 {
-    if (m_inDelete || origin == this)
+    if (m_inDelete || origin == this || scr != screen())
         return;
 
     if (formFactor() == Plasma::Types::Vertical) {
-        m_positioner->syncGeometry();
+        if (m_layout) {
+            m_layout->scheduleGeometriesSync(scr);
+        } else {
+            m_positioner->syncGeometry();
+        }
     }
 
 }
@@ -455,6 +482,52 @@ void View::setLocalGeometry(const QRect &geometry)
     updateAbsoluteGeometry();
 }
 
+QPoint View::contentOffset() const
+{
+    return m_contentOffset;
+}
+
+QRect View::fullGeometry() const
+{
+    if (!m_contentSize.isValid()) {
+        return geometry();
+    }
+
+    return QRect(geometry().topLeft() + m_contentOffset, m_contentSize);
+}
+
+void View::setContentGeometry(const QPoint &offset, const QSize &size)
+{
+    if (m_contentOffset == offset && m_contentSize == size) {
+        return;
+    }
+
+    m_contentOffset = offset;
+    m_contentSize = size;
+
+    applyContentGeometry();
+    m_effects->updateMask();
+    m_effects->updateEffects();
+}
+
+void View::applyContentGeometry()
+{
+    if (!rootObject() || !m_contentSize.isValid()) {
+        return;
+    }
+
+    rootObject()->setPosition(m_contentOffset);
+    rootObject()->setSize(m_contentSize);
+}
+
+void View::resizeEvent(QResizeEvent *event)
+{
+    PlasmaQuick::ContainmentView::resizeEvent(event);
+
+    //! the root item is resized to the window size from QQuickView
+    applyContentGeometry();
+}
+
 void View::updateAbsoluteGeometry(bool bypassChecks)
 {
     //! there was a -1 in height and width here. The reason of this
@@ -464,7 +537,7 @@ void View::updateAbsoluteGeometry(bool bypassChecks)
     //! experience with struts. Removing them in order to restore correct
     //! behavior and keeping this comment in order to check for
     //! multi-screen breakage
-    QRect absGeometry {x() + m_localGeometry.x(), y() + m_localGeometry.y()
+    QRect absGeometry {x() + m_contentOffset.x() + m_localGeometry.x(), y() + m_contentOffset.y() + m_localGeometry.y()
                 , m_localGeometry.width(), m_localGeometry.height()};
 
     if (m_absoluteGeometry == absGeometry && !bypassChecks) {
@@ -481,6 +554,9 @@ void View::updateAbsoluteGeometry(bool bypassChecks)
         //! main use of BYPASSCKECKS is from Positioner when the view changes screens
         emit m_corona->availableScreenRectChangedFrom(this);
         emit m_corona->availableScreenRegionChangedFrom(this);
+    } else if (m_corona) {
+        //! other views are not affected but the cached calculations must be updated
+        m_corona->invalidateAvailableScreenCache(this);
     }
 }
 
@@ -901,6 +977,19 @@ void View::setLayout(Layout::GenericLayout *layout)
                 }
             });
 
+            //! views of layouts on standby are hidden instead of being deleted
+            connectionsLayout << connect(m_layout, &Layout::GenericLayout::onStandbyChanged, this, [&]() {
+                if (m_layout && !inDelete()) {
+                    setVisible(!m_layout->isOnStandby());
+
+                    if (!m_layout->isOnStandby()) {
+                        m_activities = m_layout->appliedActivities();
+                        applyActivitiesToWindows();
+                        emit activitiesChanged();
+                    }
+                }
+            });
+
             //! BEGIN OF KWIN HACK
             //! IMPORTANT ::: Fixing KWin Faulty Behavior that KWin hides ALL Views when an Activity stops
             //! with no reason!!
@@ -911,14 +1000,14 @@ void View::setLayout(Layout::GenericLayout *layout)
             m_visibleHackTimer2.setSingleShot(true);
 
             connectionsLayout << connect(this, &QWindow::visibleChanged, this, [&]() {
-                if (m_layout && !inDelete() & !isVisible()) {
+                if (m_layout && !inDelete() & !isVisible() && !m_layout->isOnStandby()) {
                     m_visibleHackTimer1.start();
                     m_visibleHackTimer2.start();
                 }
             });
 
             connectionsLayout << connect(&m_visibleHackTimer1, &QTimer::timeout, this, [&]() {
-                if (m_layout && !inDelete() & !isVisible()) {
+                if (m_layout && !inDelete() & !isVisible() && !m_layout->isOnStandby()) {
                     setVisible(true);
                     applyActivitiesToWindows();
                     //qDebug() << "View:: Enforce reshow from timer 1...";
@@ -929,7 +1018,7 @@ void View::setLayout(Layout::GenericLayout *layout)
             });
 
             connectionsLayout << connect(&m_visibleHackTimer2, &QTimer::timeout, this, [&]() {
-                if (m_layout && !inDelete() && !isVisible()) {
+                if (m_layout && !inDelete() && !isVisible() && !m_layout->isOnStandby()) {
                     setVisible(true);
                     applyActivitiesToWindows();
                     //qDebug() << "View:: Enforce reshow from timer 2...";
@@ -1098,6 +1187,11 @@ ViewPart::WindowsTracker *View::windowsTracker() const
     return m_windowsTracker;
 }
 
+ViewPart::WindowTransaction *View::windowTransaction() const
+{
+    return m_windowTransaction;
+}
+
 bool View::event(QEvent *e)
 {   
     if (!m_inDelete) {
@@ -25,6 +25,7 @@
 #include "effects.h"
 #include "positioner.h"
 #include "visibilitymanager.h"
+#include "windowtransaction.h"
 #include "indicator/indicator.h"
 #include "settings/primaryconfigview.h"
 #include "windowstracker/windowstracker.h"
@@ -176,6 +177,13 @@ public:
     QRect localGeometry() const;
     void setLocalGeometry(const QRect &geometry);
 
+    //! when the window is fitted to its contents the root item keeps the full
+    //! geometry and it is placed at contentOffset inside the window
+    QPoint contentOffset() const;
+    //! the window geometry when it is not fitted to its contents
+    QRect fullGeometry() const;
+    void setContentGeometry(const QPoint &offset, const QSize &size);
+
     bool isOnActivity(const QString &activity) const;
     bool isOnAllActivities() const;
     QStringList activities() const;
@@ -190,6 +198,7 @@ public:
     ViewPart::Positioner *positioner() const;
     ViewPart::VisibilityManager *visibility() const;
     ViewPart::WindowsTracker *windowsTracker() const;
+    ViewPart::WindowTransaction *windowTransaction() const;
 
     Layout::GenericLayout *layout() const;
     void setLayout(Layout::GenericLayout *layout);
@@ -230,6 +239,7 @@ protected slots:
 protected:
     bool event(QEvent *ev) override;
     void mousePressEvent(QMouseEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
 
 signals:
     void eventTriggered(QEvent *ev);
@@ -276,7 +286,7 @@ signals:
     void customPluginsChanged();
 
 private slots:
-    void availableScreenRectChangedFrom(View *origin);
+    void availableScreenRectChangedOn(QScreen *scr, View *origin);
     void configViewCreatedFor(Latte::View *view);
     void hideWindowsForSlidingOut();
     void preferredViewForShortcutsChangedSlot(Latte::View *view);
@@ -288,6 +298,7 @@ private slots:
 
 private:
     void applyActivitiesToWindows();
+    void applyContentGeometry();
     void initSignalingForLocationChangeSliding();
     void setupWaylandIntegration();
     void updateAppletContainsMethod();
@@ -321,6 +332,9 @@ private:
     QRect m_localGeometry;
     QRect m_absoluteGeometry;
 
+    QPoint m_contentOffset{0, 0};
+    QSize m_contentSize;
+
     QStringList m_activities;
 
     //! HACK: Timers in order to handle KWin faulty
@@ -333,6 +347,7 @@ private:
     QPointer<PlasmaQuick::ConfigView> m_configView;
 
     QPointer<ViewPart::ContextMenu> m_contextMenu;
+    QPointer<ViewPart::WindowTransaction> m_windowTransaction; //needs to be created before any part that changes the window
     QPointer<ViewPart::Effects> m_effects;
     QPointer<ViewPart::Indicator> m_indicator;
     QPointer<ViewPart::Positioner> m_positioner;
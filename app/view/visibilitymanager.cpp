@@ -24,6 +24,7 @@
 #include "positioner.h"
 #include "screenedgeghostwindow.h"
 #include "view.h"
+#include "windowtransaction.h"
 #include "windowstracker/currentscreentracker.h"
 #include "../lattecorona.h"
 #include "../screenpool.h"
@@ -39,6 +40,8 @@
 #include <KWayland/Client/plasmashell.h>
 #include <KWayland/Client/surface.h>
 
+#define STRUTSTHICKNESSINTERVAL 250
+
 namespace Latte {
 namespace ViewPart {
 
@@ -66,6 +69,14 @@ VisibilityManager::VisibilityManager(PlasmaQuick::ContainmentView *view)
             }
         });
 
+        //! every thickness step of an animation would relayout all maximized windows,
+        //! so struts are updated only when the thickness has settled
+        connect(m_latteView, &Latte::View::normalThicknessChanged, this, [&]() {
+            if (m_mode == Types::AlwaysVisible) {
+                m_strutsThicknessTimer.start();
+            }
+        });
+
         connect(m_latteView->windowsTracker(), &WindowsTracker::activeWindowDraggingStarted,
                 this, &VisibilityManager::activeWindowDraggingStarted);
     }
@@ -81,15 +92,25 @@ VisibilityManager::VisibilityManager(PlasmaQuick::ContainmentView *view)
     m_timerShow.setSingleShot(true);
     m_timerHide.setSingleShot(true);
 
+    m_strutsThicknessTimer.setSingleShot(true);
+    m_strutsThicknessTimer.setInterval(STRUTSTHICKNESSINTERVAL);
+    connect(&m_strutsThicknessTimer, &QTimer::timeout, this, [&]() {
+        if (m_mode == Types::AlwaysVisible && m_latteView->screen()) {
+            updateStrutsBasedOnLayoutsAndActivities();
+        }
+    });
+
     connect(&m_timerShow, &QTimer::timeout, this, [&]() {
         if (m_isHidden) {
             //   qDebug() << "must be shown";
+            completeTransition();
             emit mustBeShown();
         }
     });
     connect(&m_timerHide, &QTimer::timeout, this, [&]() {
         if (!m_blockHiding && !m_isHidden && !m_dragEnter) {
             //   qDebug() << "must be hide";
+            completeTransition();
             emit mustBeHide();
         }
     });
@@ -103,7 +124,8 @@ VisibilityManager::~VisibilityManager()
     m_wm->removeViewStruts(*m_latteView);
 
     if (m_edgeGhostWindow) {
-        m_edgeGhostWindow->deleteLater();
+        disconnect(m_edgeGhostWindow, nullptr, this, nullptr);
+        ScreenEdgeGhostWindow::release(m_edgeGhostWindow);
     }
 }
 
@@ -130,7 +152,8 @@ void VisibilityManager::setMode(Latte::Types::Visibility mode)
 
     if (m_mode == Types::AlwaysVisible) {
         //! remove struts for old always visible mode
-        m_wm->removeViewStruts(*m_latteView);
+        m_strutsThicknessTimer.stop();
+        scheduleStrutsCommit();
     }
 
     m_timerShow.stop();
@@ -198,32 +221,34 @@ void VisibilityManager::setMode(Latte::Types::Visibility mode)
 
     case Types::DodgeActive: {
         m_connections[base] = connect(this, &VisibilityManager::containsMouseChanged
-                                      , this, &VisibilityManager::dodgeActive);
+                                      , this, &VisibilityManager::dodgeWindows);
         m_connections[base+1] = connect(m_latteView->windowsTracker()->currentScreen(), &TrackerPart::CurrentScreenTracker::activeWindowTouchingChanged
-                                        , this, &VisibilityManager::dodgeActive);
+                                        , this, &VisibilityManager::updateDodgeCondition);
 
-        dodgeActive();
+        m_dodgeCondition = dodgeCondition();
+        dodgeWindows();
         break;
     }
 
     case Types::DodgeMaximized: {
         m_connections[base] = connect(this, &VisibilityManager::containsMouseChanged
-                                      , this, &VisibilityManager::dodgeMaximized);
+                                      , this, &VisibilityManager::dodgeWindows);
         m_connections[base+1] = connect(m_latteView->windowsTracker()->currentScreen(), &TrackerPart::CurrentScreenTracker::activeWindowMaximizedChanged
-                                        , this, &VisibilityManager::dodgeMaximized);
+                                        , this, &VisibilityManager::updateDodgeCondition);
 
-        dodgeMaximized();
+        m_dodgeCondition = dodgeCondition();
+        dodgeWindows();
         break;
     }
 
     case Types::DodgeAllWindows: {
         m_connections[base] = connect(this, &VisibilityManager::containsMouseChanged
-                                      , this, &VisibilityManager::dodgeAllWindows);
-
+                                      , this, &VisibilityManager::dodgeWindows);
         m_connections[base+1] = connect(m_latteView->windowsTracker()->currentScreen(), &TrackerPart::CurrentScreenTracker::existsWindowTouchingChanged
-                                        , this, &VisibilityManager::dodgeAllWindows);
+                                        , this, &VisibilityManager::updateDodgeCondition);
 
-        dodgeAllWindows();
+        m_dodgeCondition = dodgeCondition();
+        dodgeWindows();
         break;
     }
 
@@ -243,24 +268,74 @@ void VisibilityManager::setMode(Latte::Types::Visibility mode)
 
 void VisibilityManager::updateStrutsBasedOnLayoutsAndActivities(bool forceUpdate)
 {
+    //! Force update is needed when very important events happen in DE and there is a chance
+    //! that previously even though struts where sent the DE did not accept them.
+    //! Such a case is when STOPPING an Activity and windows faulty become invisible even
+    //! though they should not. In such case setting struts when the windows are hidden
+    //! the struts do not take any effect. It is recorded first in order to be kept for
+    //! the commit that follows the thickness settling.
+    m_forceStrutsCommit = m_forceStrutsCommit || forceUpdate;
+
     bool multipleLayoutsAndCurrent = (m_corona->layoutsManager()->memoryUsage() == Types::MultipleLayouts
                                       && m_latteView->layout() && !m_latteView->positioner()->inLocationChangeAnimation()
                                       && m_latteView->layout()->isCurrent());
 
     if (m_corona->layoutsManager()->memoryUsage() == Types::SingleLayout || multipleLayoutsAndCurrent) {
-        QRect computedStruts = acceptableStruts();
-        if (m_publishedStruts != computedStruts || forceUpdate) {
-            //! Force update is needed when very important events happen in DE and there is a chance
-            //! that previously even though struts where sent the DE did not accept them.
-            //! Such a case is when STOPPING an Activity and windows faulty become invisible even
-            //! though they should not. In such case setting struts when the windows are hidden
-            //! the struts do not take any effect
-            m_publishedStruts = computedStruts;
-            m_wm->setViewStruts(*m_latteView, m_publishedStruts, m_latteView->location());
+        if (m_strutsThicknessTimer.isActive()) {
+            //! struts are updated when the thickness animation has settled, the timeout
+            //! commits them together with any forced update that was requested meanwhile
+            return;
         }
+
+        m_publishedStruts = acceptableStruts();
     } else {
         m_publishedStruts = QRect();
-        m_wm->removeViewStruts(*m_latteView);
+    }
+
+    scheduleStrutsCommit();
+}
+
+void VisibilityManager::scheduleStrutsCommit()
+{
+    if (m_latteView->layout()) {
+        m_latteView->layout()->scheduleStrutsCommit(m_latteView);
+    } else {
+        commitStruts();
+    }
+}
+
+void VisibilityManager::commitStruts()
+{
+    const QString screenName = m_latteView->screen() ? m_latteView->screen()->name() : QString();
+    const Plasma::Types::Location location = m_latteView->location();
+
+    bool changed = (m_publishedStruts != m_committedStruts);
+
+    if (!m_publishedStruts.isNull()) {
+        changed = changed || (screenName != m_committedStrutsScreen) || (location != m_committedStrutsLocation);
+    }
+
+    if (!changed && !m_forceStrutsCommit) {
+        return;
+    }
+
+    m_forceStrutsCommit = false;
+    m_committedStruts = m_publishedStruts;
+    m_committedStrutsScreen = screenName;
+    m_committedStrutsLocation = location;
+
+    qDebug() << "struts commit ::: " << screenName << " - " << location << " - " << m_committedStruts;
+
+    if (m_committedStruts.isNull()) {
+        m_latteView->windowTransaction()->schedule(WindowTransaction::Struts, [this]() {
+            m_wm->removeViewStruts(*m_latteView);
+        });
+    } else {
+        const QRect struts = m_committedStruts;
+
+        m_latteView->windowTransaction()->schedule(WindowTransaction::Struts, [this, struts, location]() {
+            m_wm->setViewStruts(*m_latteView, struts, location);
+        });
     }
 }
 
@@ -268,26 +343,29 @@ QRect VisibilityManager::acceptableStruts()
 {
     QRect calcs;
 
+    //! struts follow always the full view geometry and not the tight window
+    const QRect viewGeometry = m_latteView->fullGeometry();
+
     switch (m_latteView->location()) {
         case Plasma::Types::TopEdge: {
-            calcs = QRect(m_latteView->x(), m_latteView->y(), m_latteView->width(), m_latteView->normalThickness());
+            calcs = QRect(viewGeometry.x(), viewGeometry.y(), viewGeometry.width(), m_latteView->normalThickness());
             break;
         }
 
         case Plasma::Types::BottomEdge: {
-            int y = m_latteView->y() + m_latteView->height() - m_latteView->normalThickness();
-            calcs = QRect(m_latteView->x(), y, m_latteView->width(), m_latteView->normalThickness());
+            int y = viewGeometry.y() + viewGeometry.height() - m_latteView->normalThickness();
+            calcs = QRect(viewGeometry.x(), y, viewGeometry.width(), m_latteView->normalThickness());
             break;
         }
 
         case Plasma::Types::LeftEdge: {
-            calcs = QRect(m_latteView->x(), m_latteView->y(), m_latteView->normalThickness(), m_latteView->height());
+            calcs = QRect(viewGeometry.x(), viewGeometry.y(), m_latteView->normalThickness(), viewGeometry.height());
             break;
         }
 
         case Plasma::Types::RightEdge: {
-            int x = m_latteView->x() + m_latteView->width() - m_latteView->normalThickness();
-            calcs = QRect(x, m_latteView->y(), m_latteView->normalThickness(), m_latteView->height());
+            int x = viewGeometry.x() + viewGeometry.width() - m_latteView->normalThickness();
+            calcs = QRect(x, viewGeometry.y(), m_latteView->normalThickness(), viewGeometry.height());
             break;
         }
     }
@@ -394,6 +472,21 @@ void VisibilityManager::setTimerHide(int msec)
     emit timerHideChanged();
 }
 
+int VisibilityManager::transitions() const
+{
+    return m_transitions;
+}
+
+int VisibilityManager::cancelledTransitions() const
+{
+    return m_cancelledTransitions;
+}
+
+int VisibilityManager::lastTransitionDelay() const
+{
+    return m_lastTransitionDelay;
+}
+
 bool VisibilityManager::supportsKWinEdges() const
 {
     return (m_edgeGhostWindow != nullptr);
@@ -424,7 +517,8 @@ void VisibilityManager::hide()
 
 void VisibilityManager::show()
 {
-    if (KWindowSystem::isPlatformX11()) {
+    //! views of layouts on standby must remain hidden
+    if (KWindowSystem::isPlatformX11() && !(m_latteView->layout() && m_latteView->layout()->isOnStandby())) {
         m_latteView->setVisible(true);
     }
 }
@@ -436,23 +530,53 @@ void VisibilityManager::raiseView(bool raise)
         return;
 
     if (raise) {
-        m_timerHide.stop();
+        cancelTransition(&m_timerHide);
 
         if (!m_timerShow.isActive()) {
-            m_timerShow.start();
+            startTransition(&m_timerShow);
         }
     } else if (!m_dragEnter) {
-        m_timerShow.stop();
+        cancelTransition(&m_timerShow);
 
         if (m_hideNow) {
             m_hideNow = false;
+            m_timerHide.stop();
+            m_transitionTime.start();
+            completeTransition();
             emit mustBeHide();
         } else if (!m_timerHide.isActive()) {
-            m_timerHide.start();
+            startTransition(&m_timerHide);
         }
     }
 }
 
+void VisibilityManager::startTransition(QTimer *timer)
+{
+    m_transitionTime.start();
+    timer->start();
+}
+
+void VisibilityManager::cancelTransition(QTimer *timer)
+{
+    if (!timer->isActive()) {
+        return;
+    }
+
+    timer->stop();
+
+    m_cancelledTransitions++;
+    emit transitionsChanged();
+}
+
+void VisibilityManager::completeTransition()
+{
+    m_transitions++;
+    m_lastTransitionDelay = m_transitionTime.isValid() ? (int)m_transitionTime.elapsed() : 0;
+    m_transitionTime.invalidate();
+
+    emit transitionsChanged();
+}
+
 void VisibilityManager::raiseViewTemporarily()
 {
     if (m_raiseTemporarily)
@@ -483,15 +607,12 @@ void VisibilityManager::updateHiddenState()
         break;
 
     case Types::DodgeActive:
-        dodgeActive();
-        break;
-
     case Types::DodgeMaximized:
-        dodgeMaximized();
-        break;
-
     case Types::DodgeAllWindows:
-        dodgeAllWindows();
+        //! it is reached from activity changes, slide animations and window dragging
+        //! that are not tracked through the condition signals, so it is queried again
+        m_dodgeCondition = dodgeCondition();
+        dodgeWindows();
         break;
 
     default:
@@ -512,46 +633,47 @@ void VisibilityManager::activeWindowDraggingStarted()
     updateHiddenState();
 }
 
-void VisibilityManager::dodgeActive()
+bool VisibilityManager::dodgeCondition() const
 {
-    if (m_raiseTemporarily)
-        return;
+    auto *currentScreen = m_latteView->windowsTracker()->currentScreen();
 
-    //!don't send false raiseView signal when containing mouse
-    if (m_containsMouse) {
-        raiseView(true);
-        return;
+    switch (m_mode) {
+    case Types::DodgeActive:
+        return currentScreen->activeWindowTouching();
+
+    case Types::DodgeMaximized:
+        return currentScreen->activeWindowMaximized();
+
+    case Types::DodgeAllWindows:
+        //! active window touching is already part of any window touching
+        return currentScreen->existsWindowTouching();
+
+    default:
+        break;
     }
 
-    raiseView(!m_latteView->windowsTracker()->currentScreen()->activeWindowTouching());
+    return false;
 }
 
-void VisibilityManager::dodgeMaximized()
+void VisibilityManager::updateDodgeCondition()
 {
-    if (m_raiseTemporarily)
-        return;
+    const bool condition = dodgeCondition();
 
-    //!don't send false raiseView signal when containing mouse
-    if (m_containsMouse) {
-        raiseView(true);
+    if (m_dodgeCondition == condition) {
         return;
     }
 
-    raiseView(!m_latteView->windowsTracker()->currentScreen()->activeWindowMaximized());
+    m_dodgeCondition = condition;
+    dodgeWindows();
 }
 
-void VisibilityManager::dodgeAllWindows()
+void VisibilityManager::dodgeWindows()
 {
     if (m_raiseTemporarily)
         return;
 
-    if (m_containsMouse) {
-        raiseView(true);
-    }
-
-    bool windowIntersects{m_latteView->windowsTracker()->currentScreen()->activeWindowTouching() || m_latteView->windowsTracker()->currentScreen()->existsWindowTouching()};
-
-    raiseView(!windowIntersects);
+    //!don't send false raiseView signal when containing mouse
+    raiseView(m_containsMouse || !m_dodgeCondition);
 }
 
 void VisibilityManager::saveConfig()
@@ -709,7 +831,7 @@ void VisibilityManager::updateKWinEdgesSupport()
 void VisibilityManager::createEdgeGhostWindow()
 {
     if (!m_edgeGhostWindow) {
-        m_edgeGhostWindow = new ScreenEdgeGhostWindow(m_latteView);
+        m_edgeGhostWindow = ScreenEdgeGhostWindow::acquire(m_latteView);
 
         m_wm->setViewExtraFlags(*m_edgeGhostWindow);
 
@@ -745,7 +867,8 @@ void VisibilityManager::createEdgeGhostWindow()
 void VisibilityManager::deleteEdgeGhostWindow()
 {
     if (m_edgeGhostWindow) {
-        m_edgeGhostWindow->deleteLater();
+        disconnect(m_edgeGhostWindow, nullptr, this, nullptr);
+        ScreenEdgeGhostWindow::release(m_edgeGhostWindow);
         m_edgeGhostWindow = nullptr;
 
         for (auto &c : m_connectionsKWinEdges) {
@@ -26,6 +26,7 @@
 #include "../../liblatte2/types.h"
 
 // Qt
+#include <QElapsedTimer>
 #include <QObject>
 #include <QTimer>
 
@@ -64,6 +65,11 @@ class VisibilityManager : public QObject
     Q_PROPERTY(int timerShow READ timerShow WRITE setTimerShow NOTIFY timerShowChanged)
     Q_PROPERTY(int timerHide READ timerHide WRITE setTimerHide NOTIFY timerHideChanged)
 
+    //! show/hide transitions diagnostics that are used in order to tune the timers
+    Q_PROPERTY(int transitions READ transitions NOTIFY transitionsChanged)
+    Q_PROPERTY(int cancelledTransitions READ cancelledTransitions NOTIFY transitionsChanged)
+    Q_PROPERTY(int lastTransitionDelay READ lastTransitionDelay NOTIFY transitionsChanged)
+
 public:
     explicit VisibilityManager(PlasmaQuick::ContainmentView *view);
     virtual ~VisibilityManager();
@@ -93,6 +99,10 @@ public:
     int timerHide() const;
     void setTimerHide(int msec);
 
+    int transitions() const;
+    int cancelledTransitions() const;
+    int lastTransitionDelay() const;
+
     //! KWin Edges Support functions
     bool enableKWinEdges() const;
     void setEnableKWinEdges(bool enable);
@@ -102,6 +112,10 @@ public:
     //! called for windowTracker to reset values
     void activeWindowDraggingStarted();
 
+    //! called from layout in order to send the struts of all its views together,
+    //! struts are sent only when they differ from the last ones sent for this view and screen
+    void commitStruts();
+
 public slots:
     Q_INVOKABLE void hide();
     Q_INVOKABLE void show();
@@ -121,6 +135,7 @@ signals:
     void containsMouseChanged();
     void timerShowChanged();
     void timerHideChanged();
+    void transitionsChanged();
 
     //! KWin Edges Support signals
     void enableKWinEdgesChanged();
@@ -136,23 +151,32 @@ private slots:
 private:
     void setContainsMouse(bool contains);
 
+    //! raising and lowering is a state machine, the view is shown or hidden and a
+    //! requested transition is pending at its timer until it is applied or cancelled
     void raiseView(bool raise);
     void raiseViewTemporarily();
 
+    void startTransition(QTimer *timer);
+    void cancelTransition(QTimer *timer);
+    void completeTransition();
+
+    //! the single aggregated windows condition that the current dodge mode follows
+    bool dodgeCondition() const;
+
     //! KWin Edges Support functions
     void createEdgeGhostWindow();
     void deleteEdgeGhostWindow();
     void updateGhostWindowState();
 
+    void scheduleStrutsCommit();
     void updateStrutsBasedOnLayoutsAndActivities(bool forceUpdate = false);
     void viewEventManager(QEvent *ev);
 
     QRect acceptableStruts();
 
 private slots:
-    void dodgeAllWindows();
-    void dodgeActive();
-    void dodgeMaximized();
+    void dodgeWindows();
+    void updateDodgeCondition();
     void updateHiddenState();
 
 private:
@@ -163,6 +187,7 @@ private:
     QTimer m_timerShow;
     QTimer m_timerHide;
     QTimer m_timerStartUp;
+    QTimer m_strutsThicknessTimer;
 
     bool m_isHidden{false};
     bool m_dragEnter{false};
@@ -172,9 +197,22 @@ private:
     bool m_raiseOnDesktopChange{false};
     bool m_raiseOnActivityChange{false};
     bool m_hideNow{false};
+    bool m_dodgeCondition{false};
+
+    int m_transitions{0};
+    int m_cancelledTransitions{0};
+    int m_lastTransitionDelay{0};
+
+    QElapsedTimer m_transitionTime;
+    bool m_forceStrutsCommit{false};
 
     QRect m_publishedStruts;
 
+    //! last struts that were sent to the window manager
+    QRect m_committedStruts;
+    QString m_committedStrutsScreen;
+    Plasma::Types::Location m_committedStrutsLocation{Plasma::Types::Floating};
+
     //! KWin Edges
     bool m_enableKWinEdgesFromUser{true};
     std::array<QMetaObject::Connection, 1> m_connectionsKWinEdges;
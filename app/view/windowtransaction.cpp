@@ -0,0 +1,158 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "windowtransaction.h"
+
+// local
+#include "view.h"
+
+// Qt
+#include <QDebug>
+#include <QStringList>
+
+//! commits that took at least that long since their first request are traced
+//! even when they did not coalesce any requests
+#define SLOWCOMMITINTERVAL 16
+
+namespace Latte {
+namespace ViewPart {
+
+WindowTransaction::WindowTransaction(Latte::View *parent)
+    : QObject(parent),
+      m_view(parent)
+{
+    //! the timer covers the cases that no frame is going to be rendered
+    m_commitTimer.setSingleShot(true);
+    m_commitTimer.setInterval(0);
+    connect(&m_commitTimer, &QTimer::timeout, this, &WindowTransaction::commit);
+
+    //! afterAnimating is emitted in the gui thread just before the scene graph
+    //! synchronization, so the pending changes are shown together with the next frame
+    connect(m_view, &QQuickWindow::afterAnimating, this, &WindowTransaction::commit);
+}
+
+WindowTransaction::~WindowTransaction()
+{
+    m_commitTimer.stop();
+}
+
+bool WindowTransaction::isPending() const
+{
+    for (const auto &apply : m_pending) {
+        if (apply) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WindowTransaction::schedule(Part part, const std::function<void()> &apply)
+{
+    if (part < 0 || part >= PartsCount || !apply) {
+        return;
+    }
+
+    if (m_closed) {
+        apply();
+        return;
+    }
+
+    if (!isPending()) {
+        m_openedTime.start();
+    }
+
+    m_pending[part] = apply;
+    m_requests++;
+
+    m_commitTimer.start();
+}
+
+void WindowTransaction::close()
+{
+    commit();
+    m_closed = true;
+}
+
+void WindowTransaction::commit()
+{
+    if (!isPending()) {
+        return;
+    }
+
+    m_commitTimer.stop();
+
+    const qint64 elapsed = m_openedTime.elapsed();
+
+    QStringList parts;
+
+    //! parts that are requested while committing, e.g. the mask after the geometry,
+    //! are applied in the same commit when their turn has not come yet
+    for (int i = 0; i < PartsCount; ++i) {
+        if (!m_pending[i]) {
+            continue;
+        }
+
+        std::function<void()> apply = m_pending[i];
+        m_pending[i] = nullptr;
+
+        apply();
+        parts << partName(static_cast<Part>(i));
+    }
+
+    const int requests = m_requests;
+    m_requests = 0;
+    m_commits++;
+
+    if (isPending()) {
+        //! parts requested again while committing are left for the next commit
+        m_openedTime.start();
+        m_commitTimer.start();
+    }
+
+    //! commits of a single request in time are the common case and are not traced
+    if (requests > 1 || elapsed >= SLOWCOMMITINTERVAL) {
+        qDebug() << "window transaction ::: commit:" << m_commits << " parts:" << parts.join(",")
+                 << " requests:" << requests << " elapsed ms:" << elapsed;
+    }
+}
+
+QString WindowTransaction::partName(Part part) const
+{
+    switch (part) {
+    case Geometry:
+        return QStringLiteral("geometry");
+    case Mask:
+        return QStringLiteral("mask");
+    case BackgroundEffects:
+        return QStringLiteral("blur");
+    case Shadows:
+        return QStringLiteral("shadows");
+    case Struts:
+        return QStringLiteral("struts");
+    default:
+        break;
+    }
+
+    return QString();
+}
+
+}
+}
@@ -0,0 +1,93 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef WINDOWTRANSACTION_H
+#define WINDOWTRANSACTION_H
+
+// C++
+#include <array>
+#include <functional>
+
+// Qt
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+namespace Latte {
+class View;
+}
+
+namespace Latte {
+namespace ViewPart {
+
+//! WindowTransaction gathers all the window system changes of a view that are
+//! requested during an event loop turn, geometry, mask, blur region, shadows and
+//! struts, and pushes them to the window system together just before the next frame.
+//! When a part is requested more than once only its last request is applied.
+class WindowTransaction: public QObject
+{
+    Q_OBJECT
+
+public:
+    //! parts are committed in this order
+    enum Part {
+        Geometry = 0,
+        Mask,
+        BackgroundEffects,
+        Shadows,
+        Struts,
+        PartsCount
+    };
+
+    WindowTransaction(Latte::View *parent);
+    virtual ~WindowTransaction();
+
+    bool isPending() const;
+
+    void schedule(Part part, const std::function<void()> &apply);
+
+    //! commits everything pending and from now on requests are applied immediately,
+    //! it is used when the view is deleted
+    void close();
+
+public slots:
+    void commit();
+
+private:
+    QString partName(Part part) const;
+
+private:
+    bool m_closed{false};
+
+    int m_commits{0};
+    int m_requests{0};
+
+    std::array<std::function<void()>, PartsCount> m_pending;
+
+    QElapsedTimer m_openedTime;
+    QTimer m_commitTimer;
+
+    Latte::View *m_view{nullptr};
+};
+
+}
+}
+
+#endif
@@ -66,7 +66,9 @@ Windows::~Windows()
 
 void Windows::init()
 {
-    connect(m_wm->corona(), &Plasma::Corona::availableScreenRectChanged, this, &Windows::updateAvailableScreenGeometries);
+    connect(m_wm->corona(), &Latte::Corona::availableScreenRectChangedOn, this, [&](QScreen *screen) {
+        updateAvailableScreenGeometries(screen);
+    });
 
     connect(m_wm, &AbstractWindowInterface::windowChanged, this, [&](WindowId wid) {
         m_windows[wid] = m_wm->requestInfo(wid);
@@ -682,10 +684,10 @@ void Windows::cleanupFaultyWindows()
 }
 
 
-void Windows::updateAvailableScreenGeometries()
+void Windows::updateAvailableScreenGeometries(QScreen *screen)
 {
     for (const auto view : m_views.keys()) {
-        if (m_views[view]->enabled()) {
+        if (m_views[view]->enabled() && (!screen || view->screen() == screen)) {
             int currentScrId = view->positioner()->currentScreenId();
             QRect tempAvailableScreenGeometry = m_wm->corona()->availableScreenRectWithCriteria(currentScrId, {Types::AlwaysVisible}, {});
 
@@ -28,6 +28,7 @@
 
 #include <QHash>
 #include <QMap>
+#include <QScreen>
 
 namespace Latte {
 class View;
@@ -117,7 +118,7 @@ signals:
     void windowRemoved(const WindowId &wid);
 
 private slots:
-    void updateAvailableScreenGeometries();
+    void updateAvailableScreenGeometries(QScreen *screen = nullptr);
 
     void addRelevantLayout(Latte::View *view);
 
@@ -348,7 +348,8 @@ void WaylandInterface::setEdgeStateFor(QWindow *view, bool active) const
 {
     ViewPart::ScreenEdgeGhostWindow *window = qobject_cast<ViewPart::ScreenEdgeGhostWindow *>(view);
 
-    if (!window) {
+    //! pooled ghost windows are not used from any view when they are idle
+    if (!window || !window->parentView() || !window->surface()) {
         return;
     }
 
@@ -795,6 +795,40 @@ Window{
                           latteView.windowsTracker.allScreens.lastActiveWindow.display : "--"
                 elide: Text.ElideRight
             }
+
+            Text{
+                text: "Icons Memory (KB)"+space
+            }
+
+            Text{
+                text: latteView && Latte.IconCache.cachedMemory >= 0 ?
+                          Latte.IconCache.windowMemory(latteView) + " (shared cache: " + Latte.IconCache.cachedMemory + ")" : "--"
+            }
+
+            Text{
+                text: "Avoided Sync Rounds"+space
+            }
+
+            Text{
+                text: latteView && latteView.layout ? latteView.layout.avoidedSyncRounds : "--"
+            }
+
+            Text{
+                text: "Visibility Transitions (cancelled)"+space
+            }
+
+            Text{
+                text: latteView && latteView.visibility ?
+                          latteView.visibility.transitions + " (" + latteView.visibility.cancelledTransitions + ")" : "--"
+            }
+
+            Text{
+                text: "Last Visibility Transition Delay (ms)"+space
+            }
+
+            Text{
+                text: latteView && latteView.visibility ? latteView.visibility.lastTransitionDelay : "--"
+            }
         }
 
     }
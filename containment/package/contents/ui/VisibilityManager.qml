@@ -272,6 +272,14 @@ Item{
                 manager.slotMustBeHide();
             }
         }
+
+        onLayoutIsResuming: {
+            //! views of a layout on standby are shown again instead of being recreated
+            if (latteView && latteView.layout && latteView.layout.name === layoutName) {
+                manager.inForceHiding = false;
+                manager.slotShowDockAfterLocationChange();
+            }
+        }
     }
 
     Connections{
@@ -418,7 +426,7 @@ Item{
                 if ((plasmoid.location === PlasmaCore.Types.BottomEdge) || (plasmoid.location === PlasmaCore.Types.TopEdge)) {
                     if (plasmoid.location === PlasmaCore.Types.BottomEdge) {
                         localY = latteView.visibility.isHidden && latteView.visibility.supportsKWinEdges ?
-                                    latteView.height + tempThickness : latteView.height - tempThickness;
+                                    root.height + tempThickness : root.height - tempThickness;
                     } else if (plasmoid.location === PlasmaCore.Types.TopEdge) {
                         localY = latteView.visibility.isHidden && latteView.visibility.supportsKWinEdges ?
                                     -tempThickness : 0;
@@ -427,13 +435,13 @@ Item{
                     if (noCompositingEdit) {
                         localX = 0;
                     } else if (plasmoid.configuration.panelPosition === Latte.Types.Justify) {
-                        localX = (latteView.width/2) - tempLength/2 + root.offset;
+                        localX = (root.width/2) - tempLength/2 + root.offset;
                     } else if (root.panelAlignment === Latte.Types.Left) {
                         localX = root.offset;
                     } else if (root.panelAlignment === Latte.Types.Center) {
-                        localX = (latteView.width/2) - tempLength/2 + root.offset;
+                        localX = (root.width/2) - tempLength/2 + root.offset;
                     } else if (root.panelAlignment === Latte.Types.Right) {
-                        localX = latteView.width - layoutsContainer.mainLayout.width - space - root.offset;
+                        localX = root.width - layoutsContainer.mainLayout.width - space - root.offset;
                     }
                 } else if ((plasmoid.location === PlasmaCore.Types.LeftEdge) || (plasmoid.location === PlasmaCore.Types.RightEdge)){
                     if (plasmoid.location === PlasmaCore.Types.LeftEdge) {
@@ -441,19 +449,19 @@ Item{
                                     -tempThickness : 0;
                     } else if (plasmoid.location === PlasmaCore.Types.RightEdge) {
                         localX = latteView.visibility.isHidden && latteView.visibility.supportsKWinEdges ?
-                                    latteView.width + tempThickness : latteView.width - tempThickness;
+                                    root.width + tempThickness : root.width - tempThickness;
                     }
 
                     if (noCompositingEdit) {
                         localY = 0;
                     } else if (plasmoid.configuration.panelPosition === Latte.Types.Justify) {
-                        localY = (latteView.height/2) - tempLength/2 + root.offset;
+                        localY = (root.height/2) - tempLength/2 + root.offset;
                     } else if (root.panelAlignment === Latte.Types.Top) {
                         localY = root.offset;
                     } else if (root.panelAlignment === Latte.Types.Center) {
-                        localY = (latteView.height/2) - tempLength/2 + root.offset;
+                        localY = (root.height/2) - tempLength/2 + root.offset;
                     } else if (root.panelAlignment === Latte.Types.Bottom) {
-                        localY = latteView.height - layoutsContainer.mainLayout.height - space - root.offset;
+                        localY = root.height - layoutsContainer.mainLayout.height - space - root.offset;
                     }
                 }
             } else {
@@ -485,9 +493,9 @@ Item{
 
                 //configure the x,y position based on thickness
                 if(plasmoid.location === PlasmaCore.Types.RightEdge)
-                    localX = Math.max(0,latteView.width - tempThickness);
+                    localX = Math.max(0,root.width - tempThickness);
                 else if(plasmoid.location === PlasmaCore.Types.BottomEdge)
-                    localY = Math.max(0,latteView.height - tempThickness);
+                    localY = Math.max(0,root.height - tempThickness);
             }
         } // end of compositing calculations
 
@@ -580,17 +588,17 @@ Item{
                 }
 
                 if (plasmoid.location === PlasmaCore.Types.BottomEdge) {
-                    tempGeometry.y = latteView.height - fixedThickness;
+                    tempGeometry.y = root.height - fixedThickness;
                 } else if (plasmoid.location === PlasmaCore.Types.RightEdge) {
-                    tempGeometry.x = latteView.width - fixedThickness;
+                    tempGeometry.x = root.width - fixedThickness;
                 }
 
                 //set the boundaries for latteView local geometry
                 //qBound = qMax(min, qMin(value, max)).
-                tempGeometry.x = Math.max(0, Math.min(tempGeometry.x, latteView.width));
-                tempGeometry.y = Math.max(0, Math.min(tempGeometry.y, latteView.height));
-                tempGeometry.width = Math.min(tempGeometry.width, latteView.width);
-                tempGeometry.height = Math.min(tempGeometry.height, latteView.height);
+                tempGeometry.x = Math.max(0, Math.min(tempGeometry.x, root.width));
+                tempGeometry.y = Math.max(0, Math.min(tempGeometry.y, root.height));
+                tempGeometry.width = Math.min(tempGeometry.width, root.width);
+                tempGeometry.height = Math.min(tempGeometry.height, root.height);
             }
 
             //console.log("update geometry ::: "+tempGeometry);
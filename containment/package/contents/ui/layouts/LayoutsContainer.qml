@@ -51,7 +51,7 @@ Item{
         property: "x"
         value: {
             if ( latteView && root.isHorizontal && useMaxLength ){
-                return ((latteView.width/2) - (root.maxLength/2) + root.offset);
+                return ((root.width/2) - (root.maxLength/2) + root.offset);
             } else {
                 if ((visibilityManager.inSlidingIn || visibilityManager.inSlidingOut) && root.isVertical){
                     return;
@@ -79,7 +79,7 @@ Item{
         property: "y"
         value: {
             if ( latteView && root.isVertical && useMaxLength ) {
-                return ((latteView.height/2) - (root.maxLength/2) + root.offset);
+                return ((root.height/2) - (root.maxLength/2) + root.offset);
             } else {
                 if ((visibilityManager.inSlidingIn || visibilityManager.inSlidingOut) && root.isHorizontal){
                     return;
@@ -0,0 +1,177 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "iconcache.h"
+
+// Qt
+#include <QTimer>
+
+#define CACHEMEMORYBUDGET 16384
+#define HIDDENRELEASEINTERVAL 30000
+
+namespace Latte {
+
+IconCache::IconCache(QObject *parent)
+    : QObject(parent)
+{
+    m_pixmaps.setMaxCost(CACHEMEMORYBUDGET);
+}
+
+IconCache::~IconCache()
+{
+    m_pixmaps.clear();
+}
+
+IconCache *IconCache::self()
+{
+    static IconCache cache;
+    return &cache;
+}
+
+int IconCache::cachedMemory() const
+{
+    return m_pixmaps.totalCost();
+}
+
+int IconCache::hiddenReleaseInterval() const
+{
+    return HIDDENRELEASEINTERVAL;
+}
+
+quint64 IconCache::uniqueId()
+{
+    return ++m_lastUniqueId;
+}
+
+qint64 IconCache::pixmapBytes(const QPixmap &pixmap)
+{
+    if (pixmap.isNull()) {
+        return 0;
+    }
+
+    return (qint64)pixmap.width() * pixmap.height() * pixmap.depth() / 8;
+}
+
+bool IconCache::find(const QString &key, QPixmap *pixmap) const
+{
+    const QPixmap *cached = m_pixmaps.object(key);
+
+    if (!cached) {
+        return false;
+    }
+
+    *pixmap = *cached;
+    return true;
+}
+
+void IconCache::insert(const QString &key, const QPixmap &pixmap)
+{
+    if (key.isEmpty() || pixmap.isNull()) {
+        return;
+    }
+
+    const int cost = qMax(1, (int)(pixmapBytes(pixmap) / 1024));
+    m_pixmaps.insert(key, new QPixmap(pixmap), cost);
+
+    emit memoryChanged();
+}
+
+void IconCache::removeItem(const QObject *item)
+{
+    if (m_items.remove(item) > 0) {
+        emit memoryChanged();
+    }
+}
+
+void IconCache::setItemMemory(const QObject *item, const QObject *window, qint64 bytes)
+{
+    if (m_items.contains(item) && m_items[item].window == window && m_items[item].bytes == bytes) {
+        return;
+    }
+
+    ItemMemory memory;
+    memory.window = window;
+    memory.bytes = bytes;
+
+    m_items[item] = memory;
+
+    emit memoryChanged();
+}
+
+void IconCache::releaseWindowResources(QQuickWindow *window)
+{
+    if (!window || m_pendingWindows.contains(window)) {
+        return;
+    }
+
+    m_pendingWindows << window;
+
+    if (m_pendingWindows.count() == 1) {
+        //! all icons of a window are released together, the window is released only once for them
+        QTimer::singleShot(0, this, &IconCache::releasePendingWindows);
+    }
+}
+
+void IconCache::restoreWindowResources(QQuickWindow *window)
+{
+    if (!window) {
+        return;
+    }
+
+    m_pendingWindows.removeAll(window);
+
+    if (!window->isPersistentSceneGraph()) {
+        window->setPersistentSceneGraph(true);
+    }
+}
+
+void IconCache::releasePendingWindows()
+{
+    for (const auto &window : m_pendingWindows) {
+        if (!window || window->isVisible()) {
+            continue;
+        }
+
+        //! a non persistent scene graph is invalidated when its resources are released,
+        //! it is recreated the next time the window is exposed
+        window->setPersistentSceneGraph(false);
+        window->releaseResources();
+    }
+
+    m_pendingWindows.clear();
+}
+
+int IconCache::windowMemory(QObject *window) const
+{
+    if (!window) {
+        return 0;
+    }
+
+    qint64 bytes{0};
+
+    for (const auto &memory : m_items) {
+        if (memory.window == window) {
+            bytes += memory.bytes;
+        }
+    }
+
+    return (int)(bytes / 1024);
+}
+
+}
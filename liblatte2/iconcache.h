@@ -0,0 +1,112 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+// Qt
+#include <QCache>
+#include <QHash>
+#include <QObject>
+#include <QPixmap>
+#include <QPointer>
+#include <QQmlEngine>
+#include <QQuickWindow>
+#include <QJSEngine>
+
+namespace Latte {
+
+//! IconCache is a process wide cache for the rasterized pixmaps of IconItems.
+//! It is used in order to restore icons fast after their pixmaps and textures
+//! were released because their view was hidden for too long. It also tracks the
+//! icons memory that each view is using for diagnostic purposes.
+class IconCache final : public QObject
+{
+    Q_OBJECT
+
+    //! the shared cache memory in KB
+    Q_PROPERTY(int cachedMemory READ cachedMemory NOTIFY memoryChanged)
+
+public:
+    static IconCache *self();
+    ~IconCache() override;
+
+    int cachedMemory() const;
+
+    //! how much time a view must be hidden before its icons are released
+    int hiddenReleaseInterval() const;
+
+    quint64 uniqueId();
+
+    bool find(const QString &key, QPixmap *pixmap) const;
+    void insert(const QString &key, const QPixmap &pixmap);
+
+    void removeItem(const QObject *item);
+    void setItemMemory(const QObject *item, const QObject *window, qint64 bytes);
+
+    //! hidden windows do not synchronize their scene graph, so the textures of their
+    //! released icons are freed by releasing the scene graph of the window itself
+    void releaseWindowResources(QQuickWindow *window);
+    void restoreWindowResources(QQuickWindow *window);
+
+    static qint64 pixmapBytes(const QPixmap &pixmap);
+
+public slots:
+    //! icons memory in KB used from the provided view
+    Q_INVOKABLE int windowMemory(QObject *window) const;
+
+signals:
+    void memoryChanged();
+
+private slots:
+    void releasePendingWindows();
+
+private:
+    IconCache(QObject *parent = nullptr);
+
+private:
+    struct ItemMemory {
+        const QObject *window{nullptr};
+        qint64 bytes{0};
+    };
+
+    quint64 m_lastUniqueId{0};
+
+    //! cost is measured in KB
+    QCache<QString, QPixmap> m_pixmaps;
+
+    QHash<const QObject *, ItemMemory> m_items;
+
+    //! windows whose scene graph is released once all their icons were released
+    QList<QPointer<QQuickWindow>> m_pendingWindows;
+};
+
+static QObject *iconcache_qobject_singletontype_provider(QQmlEngine *engine, QJSEngine *scriptEngine)
+{
+    Q_UNUSED(engine)
+    Q_UNUSED(scriptEngine)
+
+// NOTE: IconCache is shared between all QML engines and it is the owner of this resource
+    QQmlEngine::setObjectOwnership(IconCache::self(), QQmlEngine::CppOwnership);
+    return IconCache::self();
+}
+
+}
+
+#endif // ICONCACHE_H
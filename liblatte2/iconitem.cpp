@@ -23,10 +23,12 @@
 #include "iconitem.h"
 
 // local
+#include "iconcache.h"
 #include "../liblatte2/extras.h"
 
 // Qt
 #include <QDebug>
+#include <QGuiApplication>
 #include <QPainter>
 #include <QPaintEngine>
 #include <QQuickWindow>
@@ -41,6 +43,14 @@
 
 namespace Latte {
 
+//! texture node that keeps the textures of the icon effect states that have been
+//! used for the current base pixmap, so switching between them is just a texture swap
+class EffectsTextureNode : public ManagedTextureNode
+{
+public:
+    QHash<int, QSharedPointer<QSGTexture>> textures;
+};
+
 IconItem::IconItem(QQuickItem *parent)
     : QQuickItem(parent),
       m_lastValidSourceName(QString()),
@@ -58,8 +68,12 @@ IconItem::IconItem(QQuickItem *parent)
             this, SIGNAL(implicitHeightChanged()));
     connect(this, &QQuickItem::enabledChanged,
             this, &IconItem::enabledChanged);
+    connect(KIconLoader::global(), SIGNAL(iconLoaderSettingsChanged()),
+            this, SLOT(schedulePixmapUpdate()));
     connect(this, &QQuickItem::windowChanged,
             this, &IconItem::schedulePixmapUpdate);
+    connect(this, &QQuickItem::windowChanged,
+            this, &IconItem::updateWindowTracking);
     connect(this, SIGNAL(overlaysChanged()),
             this, SLOT(schedulePixmapUpdate()));
     connect(this, SIGNAL(providesColorsChanged()),
@@ -69,10 +83,17 @@ IconItem::IconItem(QQuickItem *parent)
     setImplicitWidth(KIconLoader::global()->currentSize(KIconLoader::Dialog));
     setImplicitHeight(KIconLoader::global()->currentSize(KIconLoader::Dialog));
     setSmooth(true);
+
+    m_cacheId = IconCache::self()->uniqueId();
+
+    m_releaseTimer.setSingleShot(true);
+    m_releaseTimer.setInterval(IconCache::self()->hiddenReleaseInterval());
+    connect(&m_releaseTimer, &QTimer::timeout, this, &IconItem::releaseIconResources);
 }
 
 IconItem::~IconItem()
 {
+    IconCache::self()->removeItem(this);
 }
 
 void IconItem::setSource(const QVariant &source)
@@ -98,7 +119,8 @@ void IconItem::setSource(const QVariant &source)
 
         if (url.isLocalFile()) {
             m_icon = QIcon();
-            m_imageIcon = QImage(url.path());
+            m_imageIconPath = url.path();
+            m_imageIcon = QImage(m_imageIconPath);
             m_svgIconName.clear();
             m_svgIcon.reset();
         } else {
@@ -159,6 +181,7 @@ void IconItem::setSource(const QVariant &source)
                     m_svgIconName.clear();
                     m_svgIcon.reset();
                     m_imageIcon = QImage();
+                    m_imageIconPath.clear();
                 }
             }
         }
@@ -168,10 +191,12 @@ void IconItem::setSource(const QVariant &source)
         setLastLoadedSourceId("_icon_"+QString::number(m_iconCounter));
 
         m_imageIcon = QImage();
+        m_imageIconPath.clear();
         m_svgIconName.clear();
         m_svgIcon.reset();
     } else if (source.canConvert<QImage>()) {
         m_imageIcon = source.value<QImage>();
+        m_imageIconPath.clear();
         m_iconCounter++;
         setLastLoadedSourceId("_image_"+QString::number(m_iconCounter));
 
@@ -181,6 +206,7 @@ void IconItem::setSource(const QVariant &source)
     } else {
         m_icon = QIcon();
         m_imageIcon = QImage();
+        m_imageIconPath.clear();
         m_svgIconName.clear();
         m_svgIcon.reset();
     }
@@ -274,7 +300,7 @@ void IconItem::setActive(bool active)
     m_active = active;
 
     if (isComponentComplete()) {
-        schedulePixmapUpdate();
+        updateEffectState();
     }
 
     emit activeChanged();
@@ -312,7 +338,7 @@ bool IconItem::smooth() const
 
 bool IconItem::isValid() const
 {
-    return !m_icon.isNull() || m_svgIcon || !m_imageIcon.isNull();
+    return !m_icon.isNull() || m_svgIcon || !m_imageIcon.isNull() || (m_resourcesReleased && !m_imageIconPath.isEmpty());
 }
 
 int IconItem::paintedWidth() const
@@ -362,20 +388,33 @@ QSGNode *IconItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *update
         return nullptr;
     }
 
-    ManagedTextureNode *textureNode = dynamic_cast<ManagedTextureNode *>(oldNode);
+    EffectsTextureNode *textureNode = dynamic_cast<EffectsTextureNode *>(oldNode);
 
     if (!textureNode || m_textureChanged) {
         if (oldNode)
             delete oldNode;
 
-        textureNode = new ManagedTextureNode;
-        textureNode->setTexture(QSharedPointer<QSGTexture>(window()->createTextureFromImage(m_iconPixmap.toImage(), QQuickWindow::TextureCanUseAtlas)));
-        textureNode->setFiltering(smooth() ? QSGTexture::Linear : QSGTexture::Nearest);
-
+        textureNode = new EffectsTextureNode;
+        m_effectStateChanged = true;
         m_sizeChanged = true;
         m_textureChanged = false;
     }
 
+    if (m_effectStateChanged) {
+        //! effect states that were already used are just a texture swap
+        QSharedPointer<QSGTexture> texture = textureNode->textures.value(m_effectState);
+
+        if (!texture) {
+            texture = QSharedPointer<QSGTexture>(window()->createTextureFromImage(m_iconPixmap.toImage(), QQuickWindow::TextureCanUseAtlas));
+            textureNode->textures[m_effectState] = texture;
+        }
+
+        textureNode->setTexture(texture);
+        textureNode->setFiltering(smooth() ? QSGTexture::Linear : QSGTexture::Nearest);
+
+        m_effectStateChanged = false;
+    }
+
     if (m_sizeChanged) {
         const auto iconSize = qMin(boundingRect().size().width(), boundingRect().size().height());
         const QRectF destRect(QPointF(boundingRect().center() - QPointF(iconSize / 2, iconSize / 2)), QSizeF(iconSize, iconSize));
@@ -391,9 +430,149 @@ void IconItem::schedulePixmapUpdate()
     polish();
 }
 
+void IconItem::updateWindowTracking()
+{
+    if (m_trackedWindow == window()) {
+        return;
+    }
+
+    disconnect(m_windowVisibleConnection);
+    m_releaseTimer.stop();
+
+    m_trackedWindow = window();
+
+    if (m_trackedWindow) {
+        m_windowVisibleConnection = connect(m_trackedWindow.data(), &QWindow::visibleChanged, this, &IconItem::windowVisibleChanged);
+        windowVisibleChanged(m_trackedWindow->isVisible());
+    }
+
+    updateMemoryUsage();
+}
+
+void IconItem::windowVisibleChanged(bool visible)
+{
+    if (!visible) {
+        if (!m_resourcesReleased && !m_releaseTimer.isActive()) {
+            m_releaseTimer.start();
+        }
+
+        return;
+    }
+
+    m_releaseTimer.stop();
+
+    if (m_resourcesReleased) {
+        //! icons are restored from IconCache, only cache misses need to be rendered again
+        m_resourcesReleased = false;
+        IconCache::self()->restoreWindowResources(m_trackedWindow.data());
+        schedulePixmapUpdate();
+    }
+}
+
+void IconItem::releaseIconResources()
+{
+    if (m_resourcesReleased || (m_trackedWindow && m_trackedWindow->isVisible())) {
+        return;
+    }
+
+    m_resourcesReleased = true;
+
+    //! the rasterized icon can always be found again through IconCache or the icon sources,
+    //! images provided directly as source can not be recreated so they are kept
+    m_iconPixmap = QPixmap();
+    m_pixmapKey.clear();
+
+    if (!m_imageIconPath.isEmpty()) {
+        m_imageIcon = QImage();
+    }
+
+    m_textureChanged = true;
+    updateMemoryUsage();
+
+    //! the texture node of a hidden window is deleted only when its scene graph is released
+    update();
+    IconCache::self()->releaseWindowResources(m_trackedWindow.data());
+}
+
+void IconItem::updateMemoryUsage()
+{
+    //! the texture that is uploaded from m_iconPixmap is considered equal to it
+    const qint64 pixmapBytes = IconCache::pixmapBytes(m_iconPixmap);
+    const qint64 imageBytes = m_imageIcon.isNull() ? 0 : (qint64)m_imageIcon.byteCount();
+
+    IconCache::self()->setItemMemory(this, m_trackedWindow.data(), (2 * pixmapBytes) + imageBytes);
+}
+
 void IconItem::enabledChanged()
 {
-    schedulePixmapUpdate();
+    updateEffectState();
+}
+
+int IconItem::currentEffectState() const
+{
+    if (!isEnabled()) {
+        return KIconLoader::DisabledState;
+    } else if (m_active) {
+        return KIconLoader::ActiveState;
+    }
+
+    return KIconLoader::DefaultState;
+}
+
+QPixmap IconItem::effectPixmap(const QPixmap &base, const QString &key, int state) const
+{
+    auto *effect = KIconLoader::global()->iconEffect();
+
+    if (state == KIconLoader::DefaultState || !effect->hasEffect(KIconLoader::Desktop, state)) {
+        return base;
+    }
+
+    //! effect variants are cached alongside their base pixmap and they follow the user effect settings
+    const QString variantKey = key.isEmpty() ? QString() : key + QLatin1Char('_') + effect->fingerprint(KIconLoader::Desktop, state);
+    QPixmap variant;
+
+    if (!variantKey.isEmpty() && IconCache::self()->find(variantKey, &variant)) {
+        return variant;
+    }
+
+    variant = effect->apply(base, KIconLoader::Desktop, state);
+
+    if (!variantKey.isEmpty()) {
+        IconCache::self()->insert(variantKey, variant);
+    }
+
+    return variant;
+}
+
+void IconItem::updateEffectState()
+{
+    if (!isComponentComplete() || m_resourcesReleased) {
+        return;
+    }
+
+    const int state = currentEffectState();
+
+    if (state == m_effectState && !m_iconPixmap.isNull()) {
+        return;
+    }
+
+    const auto size = qMin(width(), height());
+    QPixmap base;
+
+    //! when the base pixmap is still available only the effect variant is swapped,
+    //! otherwise the icon must be loaded again
+    if (size <= 0 || m_pixmapKey.isEmpty() || m_pixmapKey != cacheKey(static_cast<int>(size))
+            || !IconCache::self()->find(m_pixmapKey, &base)) {
+        schedulePixmapUpdate();
+        return;
+    }
+
+    m_iconPixmap = effectPixmap(base, m_pixmapKey, state);
+    m_effectState = state;
+    m_effectStateChanged = true;
+    updateMemoryUsage();
+
+    update();
 }
 
 QColor IconItem::backgroundColor() const
@@ -476,20 +655,54 @@ void IconItem::updateColors()
     }
 }
 
+QString IconItem::cacheKey(int size) const
+{
+    //! plasma svg icons are rendered from their shared renderers and follow the theme,
+    //! so they are not cached
+    if (m_svgIcon || m_lastLoadedSourceId.isEmpty()) {
+        return QString();
+    }
+
+    //! sources that were provided as QIcon/QImage are unique for each item
+    const bool sharedSource = !m_lastLoadedSourceId.startsWith(QLatin1String("_icon_"))
+            && !m_lastLoadedSourceId.startsWith(QLatin1String("_image_"));
+
+    const auto *iconTheme = KIconLoader::global()->theme();
+    const qreal dpr = window() ? window()->devicePixelRatio() : qApp->devicePixelRatio();
+
+    QString key = sharedSource ? m_lastLoadedSourceId : QString::number(m_cacheId) + m_lastLoadedSourceId;
+
+    key += QLatin1Char('_') + (iconTheme ? iconTheme->internalName() : QString())
+            + QLatin1Char('_') + QString::number(size)
+            + QLatin1Char('_') + QString::number(dpr)
+            //! symbolic icons are recolored from the palette
+            + QLatin1Char('_') + QString::number(QGuiApplication::palette().cacheKey())
+            + QLatin1Char('_') + m_overlays.join(QLatin1Char(','));
+
+    return key;
+}
+
 void IconItem::loadPixmap()
 {
-    if (!isComponentComplete()) {
+    if (!isComponentComplete() || m_resourcesReleased) {
         return;
     }
 
     const auto size = qMin(width(), height());
+    const QString key = size > 0 ? cacheKey(static_cast<int>(size)) : QString();
+    bool fromCache{false};
     //final pixmap to paint
     QPixmap result;
 
     if (size <= 0) {
         m_iconPixmap = QPixmap();
+        m_pixmapKey.clear();
+        updateMemoryUsage();
         update();
         return;
+    } else if (!key.isEmpty() && IconCache::self()->find(key, &result)) {
+        //! restored from cache, overlays are already drawn
+        fromCache = true;
     } else if (m_svgIcon) {
         m_svgIcon->resize(size, size);
 
@@ -522,35 +735,45 @@ void IconItem::loadPixmap()
     } else if (!m_icon.isNull()) {
         result = m_icon.pixmap(QSize(static_cast<int>(size), static_cast<int>(size))
                                * (window() ? window()->devicePixelRatio() : qApp->devicePixelRatio()));
-    } else if (!m_imageIcon.isNull()) {
+    } else if (!m_imageIcon.isNull() || !m_imageIconPath.isEmpty()) {
+        if (m_imageIcon.isNull()) {
+            //! image was released when its view was hidden
+            m_imageIcon = QImage(m_imageIconPath);
+        }
+
         result = QPixmap::fromImage(m_imageIcon);
     } else {
         m_iconPixmap = QPixmap();
+        m_pixmapKey.clear();
+        updateMemoryUsage();
         update();
         return;
     }
 
-    // Strangely KFileItem::overlays() returns empty string-values, so
-    // we need to check first whether an overlay must be drawn at all.
-    // It is more efficient to do it here, as KIconLoader::drawOverlays()
-    // assumes that an overlay will be drawn and has some additional
-    // setup time.
-    for (const QString &overlay : m_overlays) {
-        if (!overlay.isEmpty()) {
-            // There is at least one overlay, draw all overlays above m_pixmap
-            // and cancel the check
-            KIconLoader::global()->drawOverlays(m_overlays, result, KIconLoader::Desktop);
-            break;
+    if (!fromCache) {
+        // Strangely KFileItem::overlays() returns empty string-values, so
+        // we need to check first whether an overlay must be drawn at all.
+        // It is more efficient to do it here, as KIconLoader::drawOverlays()
+        // assumes that an overlay will be drawn and has some additional
+        // setup time.
+        for (const QString &overlay : m_overlays) {
+            if (!overlay.isEmpty()) {
+                // There is at least one overlay, draw all overlays above m_pixmap
+                // and cancel the check
+                KIconLoader::global()->drawOverlays(m_overlays, result, KIconLoader::Desktop);
+                break;
+            }
         }
-    }
 
-    if (!isEnabled()) {
-        result = KIconLoader::global()->iconEffect()->apply(result, KIconLoader::Desktop, KIconLoader::DisabledState);
-    } else if (m_active) {
-        result = KIconLoader::global()->iconEffect()->apply(result, KIconLoader::Desktop, KIconLoader::ActiveState);
+        if (!key.isEmpty()) {
+            IconCache::self()->insert(key, result);
+        }
     }
 
-    m_iconPixmap = result;
+    m_pixmapKey = key;
+    m_effectState = currentEffectState();
+    m_iconPixmap = effectPixmap(result, key, m_effectState);
+    updateMemoryUsage();
 
     if (m_providesColors && m_lastLoadedSourceId != m_lastColorsSourceId) {
         m_lastColorsSourceId = m_lastLoadedSourceId;
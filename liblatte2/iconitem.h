@@ -31,6 +31,8 @@
 #include <QIcon>
 #include <QImage>
 #include <QPixmap>
+#include <QPointer>
+#include <QTimer>
 
 // Plasma
 #include <Plasma/Svg>
@@ -172,8 +174,19 @@ private slots:
     void schedulePixmapUpdate();
     void enabledChanged();
 
+    void releaseIconResources();
+    void updateEffectState();
+    void updateWindowTracking();
+    void windowVisibleChanged(bool visible);
+
 private:
     void loadPixmap();
+    void updateMemoryUsage();
+
+    int currentEffectState() const;
+
+    QString cacheKey(int size) const;
+    QPixmap effectPixmap(const QPixmap &base, const QString &key, int state) const;
     void updateColors();
     void setLastLoadedSourceId(QString id);
     void setLastValidSourceName(QString name);
@@ -188,8 +201,12 @@ private:
 
     bool m_textureChanged;
     bool m_sizeChanged;
+    bool m_effectStateChanged{false};
     bool m_usesPlasmaTheme;
 
+    //! pixmaps and textures have been released because the view was hidden for too long
+    bool m_resourcesReleased{false};
+
     QColor m_backgroundColor;
     QColor m_glowColor;
 
@@ -199,6 +216,23 @@ private:
     std::unique_ptr<Plasma::Svg> m_svgIcon;
     QString m_svgIconName;
 
+    //! local file that m_imageIcon was loaded from, it is used to reload it
+    //! after its resources were released
+    QString m_imageIconPath;
+
+    //! unique id in IconCache for sources that can not be shared between items
+    quint64 m_cacheId{0};
+
+    //! IconCache key of the base pixmap that m_iconPixmap was produced from
+    QString m_pixmapKey;
+
+    //! KIconLoader::States that m_iconPixmap is representing
+    int m_effectState{0};
+
+    QTimer m_releaseTimer;
+    QPointer<QQuickWindow> m_trackedWindow;
+    QMetaObject::Connection m_windowVisibleConnection;
+
     //! can be used to track changes during source "changes" independent
     //! of the source type
     int m_iconCounter{0};
@@ -22,6 +22,7 @@
 
 // local
 #include "backgroundtracker.h"
+#include "iconcache.h"
 #include "iconitem.h"
 #include "quickwindowsystem.h"
 #include "types.h"
@@ -35,5 +36,6 @@ void LattePlugin::registerTypes(const char *uri)
     qmlRegisterUncreatableType<Latte::Types>(uri, 0, 2, "Types", "Latte Types uncreatable");
     qmlRegisterType<Latte::BackgroundTracker>(uri, 0, 2, "BackgroundTracker");
     qmlRegisterType<Latte::IconItem>(uri, 0, 2, "IconItem");
+    qmlRegisterSingletonType<Latte::IconCache>(uri, 0, 2, "IconCache", &Latte::iconcache_qobject_singletontype_provider);
     qmlRegisterSingletonType<Latte::QuickWindowSystem>(uri, 0, 2, "WindowSystem", &Latte::windowsystem_qobject_singletontype_provider);
 }